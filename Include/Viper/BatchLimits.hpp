@@ -0,0 +1,149 @@
+#ifndef VIPER_BATCH_LIMITS_HPP
+#define VIPER_BATCH_LIMITS_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Viper/Conversions.hpp"
+
+namespace Viper {
+namespace Details {
+  inline std::size_t estimate_size(const RawColumn& column) {
+    constexpr auto FIXED_SIZE = std::size_t(8);
+    if(column.m_type == RawColumn::Type::TEXT ||
+        column.m_type == RawColumn::Type::BLOB) {
+      return column.m_size + FIXED_SIZE;
+    }
+    return FIXED_SIZE;
+  }
+}
+
+  //! Bounds the number of rows written by a single insert or upsert.
+  struct BatchLimits {
+
+    //! The maximum number of rows in a batch.
+    std::size_t m_max_rows = std::numeric_limits<std::size_t>::max();
+
+    //! The maximum number of parameters bound to a batch.
+    std::size_t m_max_parameters = std::numeric_limits<std::size_t>::max();
+
+    //! The maximum number of bytes of values in a batch, a single row
+    //! exceeding this budget is written on its own.
+    std::size_t m_max_bytes = std::numeric_limits<std::size_t>::max();
+  };
+
+  //! Reports the batches an insert or upsert was split into.
+  struct BatchStatistics {
+
+    //! The number of batches written.
+    std::uint64_t m_batches = 0;
+
+    //! The number of rows written.
+    std::uint64_t m_rows = 0;
+
+    //! The estimated number of bytes of values written.
+    std::uint64_t m_bytes = 0;
+
+    //! The number of rows in the largest batch written.
+    std::size_t m_largest_batch = 0;
+
+    //! The number of rows in the most recent batch written.
+    std::size_t m_last_batch = 0;
+  };
+
+  //! Retains the memory used to write batches so that it can be reused by
+  //! subsequent batches without allocating.
+  struct WriteBuffer {
+
+    //! The query text of the most recently built batch.
+    std::string m_query;
+
+    //! The parameters of a batch, stored row after row.
+    std::vector<RawColumn> m_parameters;
+
+    //! Stores the bytes referenced by the parameters.
+    std::deque<std::string> m_values;
+  };
+
+  //! Splits the rows of an insert or upsert into batches that fit within a
+  //! set of limits, pulling each row from the range exactly once.
+  /*!
+    \param statement The insert or upsert statement whose rows are written.
+    \param limits The limits each batch must fit within.
+    \param buffer Stores the parameters of each batch.
+    \param statistics Updated with every batch written.
+    \param f The function called with the number of rows in a batch and a
+           pointer to its parameters, stored row after row.
+  */
+  template<typename S, typename F>
+  void write_batches(const S& statement, const BatchLimits& limits,
+      WriteBuffer& buffer, BatchStatistics& statistics, F&& f) {
+    auto& row = statement.get_row();
+    auto column_count = row.get_columns().size();
+    if(column_count == 0 || statement.get_begin() == statement.get_end()) {
+      return;
+    }
+    auto row_limit = std::max<std::size_t>(1,
+      std::min(limits.m_max_rows, limits.m_max_parameters / column_count));
+    auto& parameters = buffer.m_parameters;
+    auto& values = buffer.m_values;
+    auto rows = std::size_t(0);
+    auto bytes = std::size_t(0);
+    auto store = [&] (const auto& value) {
+      auto offset = rows * column_count;
+      if(parameters.size() < offset + column_count) {
+        parameters.resize(offset + column_count);
+        values.resize(offset + column_count);
+      }
+      auto size = std::size_t(0);
+      for(auto i = std::size_t(0); i != column_count; ++i) {
+        row.store_value(value, static_cast<int>(i), parameters[offset + i],
+          values[offset + i]);
+        size += Details::estimate_size(parameters[offset + i]);
+      }
+      return size;
+    };
+    auto flush = [&] {
+      f(rows, parameters.data());
+      ++statistics.m_batches;
+      statistics.m_rows += rows;
+      statistics.m_bytes += bytes;
+      statistics.m_largest_batch = std::max(statistics.m_largest_batch, rows);
+      statistics.m_last_batch = rows;
+      rows = 0;
+      bytes = 0;
+    };
+    for(auto i = statement.get_begin(); i != statement.get_end(); ++i) {
+      auto size = store(*i);
+      if(rows != 0 && (bytes >= limits.m_max_bytes ||
+          size > limits.m_max_bytes - bytes)) {
+        auto offset = rows * column_count;
+        flush();
+        for(auto j = std::size_t(0); j != column_count; ++j) {
+          auto& column = parameters[offset + j];
+          auto is_buffered = (column.m_type == RawColumn::Type::TEXT ||
+            column.m_type == RawColumn::Type::BLOB) &&
+            column.m_data == values[offset + j].data();
+          values[j].swap(values[offset + j]);
+          parameters[j] = column;
+          if(is_buffered) {
+            parameters[j].m_data = values[j].data();
+          }
+        }
+      }
+      ++rows;
+      bytes += size;
+      if(rows == row_limit) {
+        flush();
+      }
+    }
+    if(rows != 0) {
+      flush();
+    }
+  }
+}
+
+#endif
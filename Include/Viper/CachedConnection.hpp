@@ -0,0 +1,470 @@
+#ifndef VIPER_CACHED_CONNECTION_HPP
+#define VIPER_CACHED_CONNECTION_HPP
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "Viper/Conversions.hpp"
+#include "Viper/RollbackStatement.hpp"
+#include "Viper/SelectStatement.hpp"
+
+namespace Viper {
+namespace Details {
+  inline bool is_keyword(std::string_view query, std::size_t position,
+      std::string_view keyword) {
+    auto is_identifier = [] (char c) {
+      return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    };
+    if(query.size() - position < keyword.size() ||
+        (position != 0 && is_identifier(query[position - 1]))) {
+      return false;
+    }
+    for(auto i = std::size_t(0); i != keyword.size(); ++i) {
+      if(std::toupper(static_cast<unsigned char>(query[position + i])) !=
+          keyword[i]) {
+        return false;
+      }
+    }
+    auto end = position + keyword.size();
+    return end == query.size() || !is_identifier(query[end]);
+  }
+
+  inline void append_tables(std::string_view query,
+      std::vector<std::string>& tables) {
+    auto i = std::size_t(0);
+    while(i != query.size()) {
+      auto c = query[i];
+      if(c == '\'' || c == '"' || c == '`') {
+        ++i;
+        while(i != query.size() && query[i] != c) {
+          if(query[i] == '\\' && i + 1 != query.size()) {
+            ++i;
+          }
+          ++i;
+        }
+        if(i != query.size()) {
+          ++i;
+        }
+        continue;
+      }
+      if(!is_keyword(query, i, "FROM") && !is_keyword(query, i, "JOIN")) {
+        ++i;
+        continue;
+      }
+      i += 4;
+      while(i != query.size() &&
+          std::isspace(static_cast<unsigned char>(query[i]))) {
+        ++i;
+      }
+      auto start = i;
+      while(i != query.size() &&
+          !std::isspace(static_cast<unsigned char>(query[i])) &&
+          query[i] != '(' && query[i] != ')' && query[i] != ',' &&
+          query[i] != ';') {
+        ++i;
+      }
+      if(i != start) {
+        auto table = std::string(query.substr(start, i - start));
+        if(std::find(tables.begin(), tables.end(), table) == tables.end()) {
+          tables.push_back(std::move(table));
+        }
+      }
+    }
+  }
+}
+
+  /*! \brief Wraps a connection to memoize the rows of its selects, so that
+             frequently read and rarely written tables are served from
+             memory.
+      \details Inserts, upserts, updates and deletes executed through the
+               wrapper invalidate the cached selects reading the table they
+               write to, whether directly or through a subquery. Writes made
+               by any other connection are only observed once a cached select
+               expires. Rolling back a transaction clears the cache, since
+               selects made within it may have read writes that were
+               discarded. Selects are keyed by the type of row and the SQL
+               the connection renders for them, so two rows of the same type
+               that bind the same column names to different members must not
+               be selected through the same cache. Like the connection it
+               wraps, the wrapper must not be used by more than one thread
+               at a time.
+      \tparam C The type of connection to wrap, which renders the SQL of a
+              select through append_query.
+   */
+  template<typename C>
+  class CachedConnection {
+    public:
+
+      //! The type of connection to wrap.
+      using Connection = C;
+
+      //! The type of clock used to expire cached selects.
+      using Clock = std::chrono::steady_clock;
+
+      //! Stores counters measuring the effectiveness of the cache.
+      struct Statistics {
+
+        //! The number of selects served from the cache.
+        std::uint64_t m_hits = 0;
+
+        //! The number of selects executed on the connection.
+        std::uint64_t m_misses = 0;
+
+        //! The number of cached selects that expired.
+        std::uint64_t m_expirations = 0;
+
+        //! The number of cached selects removed by a write to their table.
+        std::uint64_t m_invalidations = 0;
+
+        //! The number of cached selects removed to make room for others.
+        std::uint64_t m_evictions = 0;
+
+        //! The number of selects cached.
+        std::size_t m_entries = 0;
+
+        //! The estimated number of bytes used by the cached selects.
+        std::size_t m_bytes = 0;
+      };
+
+      //! The number of bytes cached by default.
+      static constexpr auto DEFAULT_CAPACITY = std::size_t(64) << 20;
+
+      //! The time a select is cached for by default.
+      static constexpr auto DEFAULT_TIME_TO_LIVE = std::chrono::seconds(60);
+
+      //! Constructs a cache around a connection.
+      /*!
+        \param connection The connection to execute statements on.
+        \param capacity The maximum number of bytes to cache, a capacity of
+               0 disables caching.
+        \param time_to_live The time a select is served from the cache
+               before it is executed again.
+      */
+      explicit CachedConnection(Connection connection,
+        std::size_t capacity = DEFAULT_CAPACITY,
+        Clock::duration time_to_live = DEFAULT_TIME_TO_LIVE);
+
+      //! Returns the wrapped connection, statements executed on it directly
+      //! bypass the cache.
+      Connection& get_connection();
+
+      //! Returns the maximum number of bytes to cache.
+      std::size_t get_capacity() const;
+
+      //! Sets the maximum number of bytes to cache, evicting the least
+      //! recently used selects to fit.
+      void set_capacity(std::size_t capacity);
+
+      //! Returns the time a select is served from the cache.
+      Clock::duration get_time_to_live() const;
+
+      //! Sets the time a select is served from the cache, applying to
+      //! selects cached from now on.
+      void set_time_to_live(Clock::duration time_to_live);
+
+      //! Returns the counters measuring the effectiveness of the cache.
+      const Statistics& get_statistics() const;
+
+      //! Returns the fraction of selects served from the cache.
+      double get_hit_ratio() const;
+
+      //! Opens the connection.
+      void open();
+
+      //! Closes the connection and clears the cache.
+      void close();
+
+      //! Executes a select, serving its rows from the cache when the same
+      //! select of the same type of row was cached and has not expired.
+      /*!
+        \param statement The statement to execute.
+      */
+      template<typename T, typename D>
+      void execute(const SelectStatement<T, D>& statement);
+
+      //! Executes a raw SQL query and clears the cache, since the tables it
+      //! writes to are unknown.
+      /*!
+        \param statement The statement to execute.
+      */
+      void execute(std::string_view statement);
+
+      //! Rolls back a transaction and clears the cache, since selects made
+      //! within the transaction may have read the writes it discards.
+      /*!
+        \param statement The statement to execute.
+      */
+      void execute(const RollbackStatement& statement);
+
+      //! Executes any other statement, invalidating the cached selects of
+      //! the table it writes to, if any.
+      /*!
+        \param statement The statement to execute.
+      */
+      template<typename S>
+      void execute(const S& statement);
+
+      //! Removes the cached selects reading from a table, including those
+      //! reading it through a subquery.
+      /*!
+        \param table The name of the table that was written to.
+      */
+      void invalidate(const std::string& table);
+
+      //! Removes every cached select.
+      void clear();
+
+    private:
+      struct Entry {
+        const std::string* m_key;
+        std::shared_ptr<void> m_rows;
+        std::vector<std::string> m_tables;
+        std::size_t m_bytes;
+        Clock::time_point m_expiry;
+      };
+      using Entries = std::list<Entry>;
+      Connection m_connection;
+      std::size_t m_capacity;
+      Clock::duration m_time_to_live;
+      Statistics m_statistics;
+      Entries m_entries;
+      std::unordered_map<std::string, typename Entries::iterator> m_index;
+      std::unordered_map<std::string, std::unordered_set<const std::string*>>
+        m_tables;
+
+      void erase(typename Entries::iterator entry);
+      void evict();
+  };
+
+  template<typename C>
+  CachedConnection<C>::CachedConnection(Connection connection,
+      std::size_t capacity, Clock::duration time_to_live)
+      : m_connection(std::move(connection)),
+        m_capacity(capacity),
+        m_time_to_live(time_to_live) {}
+
+  template<typename C>
+  typename CachedConnection<C>::Connection&
+      CachedConnection<C>::get_connection() {
+    return m_connection;
+  }
+
+  template<typename C>
+  std::size_t CachedConnection<C>::get_capacity() const {
+    return m_capacity;
+  }
+
+  template<typename C>
+  void CachedConnection<C>::set_capacity(std::size_t capacity) {
+    m_capacity = capacity;
+    evict();
+  }
+
+  template<typename C>
+  typename CachedConnection<C>::Clock::duration
+      CachedConnection<C>::get_time_to_live() const {
+    return m_time_to_live;
+  }
+
+  template<typename C>
+  void CachedConnection<C>::set_time_to_live(Clock::duration time_to_live) {
+    m_time_to_live = time_to_live;
+  }
+
+  template<typename C>
+  const typename CachedConnection<C>::Statistics&
+      CachedConnection<C>::get_statistics() const {
+    return m_statistics;
+  }
+
+  template<typename C>
+  double CachedConnection<C>::get_hit_ratio() const {
+    auto total = m_statistics.m_hits + m_statistics.m_misses;
+    if(total == 0) {
+      return 0;
+    }
+    return static_cast<double>(m_statistics.m_hits) / total;
+  }
+
+  template<typename C>
+  void CachedConnection<C>::open() {
+    m_connection.open();
+  }
+
+  template<typename C>
+  void CachedConnection<C>::close() {
+    clear();
+    m_connection.close();
+  }
+
+  template<typename C>
+  template<typename T, typename D>
+  void CachedConnection<C>::execute(const SelectStatement<T, D>& statement) {
+    using Type = typename T::Type;
+    auto key = std::string(typeid(T).name());
+    key += '\0';
+    auto offset = key.size();
+    m_connection.append_query(statement, key);
+    auto now = Clock::now();
+    auto index = m_index.find(key);
+    if(index != m_index.end()) {
+      auto entry = index->second;
+      if(entry->m_expiry > now) {
+        ++m_statistics.m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+        auto& rows = *std::static_pointer_cast<std::vector<Type>>(
+          entry->m_rows);
+        auto destination = statement.get_first();
+        for(auto& row : rows) {
+          *destination = row;
+          ++destination;
+        }
+        return;
+      }
+      ++m_statistics.m_expirations;
+      erase(entry);
+    }
+    ++m_statistics.m_misses;
+    auto rows = std::make_shared<std::vector<Type>>();
+    m_connection.execute(SelectStatement(statement.get_row(),
+      statement.get_clause(), std::back_inserter(*rows)));
+    auto bytes = key.size() + sizeof(Entry) + rows->size() * sizeof(Type);
+    auto& columns = statement.get_row().get_columns();
+    auto column = RawColumn();
+    auto buffer = std::string();
+    for(auto& row : *rows) {
+      for(auto i = std::size_t(0); i != columns.size(); ++i) {
+        buffer.clear();
+        statement.get_row().store_value(row, static_cast<int>(i), column,
+          buffer);
+        if(column.m_type == RawColumn::Type::TEXT ||
+            column.m_type == RawColumn::Type::BLOB) {
+          bytes += column.m_size;
+        }
+      }
+    }
+    auto destination = statement.get_first();
+    for(auto& row : *rows) {
+      *destination = row;
+      ++destination;
+    }
+    if(bytes > m_capacity) {
+      return;
+    }
+    auto tables = std::vector<std::string>();
+    Details::append_tables(std::string_view(key).substr(offset), tables);
+    auto entry = m_entries.insert(m_entries.begin(),
+      Entry{nullptr, std::move(rows), std::move(tables), bytes,
+        now + m_time_to_live});
+    index = m_index.emplace(std::move(key), entry).first;
+    entry->m_key = &index->first;
+    for(auto& table : entry->m_tables) {
+      m_tables[table].insert(entry->m_key);
+    }
+    ++m_statistics.m_entries;
+    m_statistics.m_bytes += bytes;
+    evict();
+  }
+
+  template<typename C>
+  void CachedConnection<C>::execute(std::string_view statement) {
+    try {
+      m_connection.execute(statement);
+    } catch(...) {
+      clear();
+      throw;
+    }
+    clear();
+  }
+
+  template<typename C>
+  void CachedConnection<C>::execute(const RollbackStatement& statement) {
+    try {
+      m_connection.execute(statement);
+    } catch(...) {
+      clear();
+      throw;
+    }
+    clear();
+  }
+
+  template<typename C>
+  template<typename S>
+  void CachedConnection<C>::execute(const S& statement) {
+    if constexpr(requires { statement.get_table(); }) {
+      try {
+        m_connection.execute(statement);
+      } catch(...) {
+        invalidate(statement.get_table());
+        throw;
+      }
+      invalidate(statement.get_table());
+    } else {
+      m_connection.execute(statement);
+    }
+  }
+
+  template<typename C>
+  void CachedConnection<C>::invalidate(const std::string& table) {
+    auto keys = m_tables.find(table);
+    if(keys == m_tables.end()) {
+      return;
+    }
+    auto pending = std::vector<const std::string*>(keys->second.begin(),
+      keys->second.end());
+    for(auto key : pending) {
+      auto index = m_index.find(*key);
+      if(index != m_index.end()) {
+        ++m_statistics.m_invalidations;
+        erase(index->second);
+      }
+    }
+  }
+
+  template<typename C>
+  void CachedConnection<C>::clear() {
+    m_statistics.m_entries = 0;
+    m_statistics.m_bytes = 0;
+    m_entries.clear();
+    m_index.clear();
+    m_tables.clear();
+  }
+
+  template<typename C>
+  void CachedConnection<C>::erase(typename Entries::iterator entry) {
+    for(auto& table : entry->m_tables) {
+      auto keys = m_tables.find(table);
+      if(keys != m_tables.end()) {
+        keys->second.erase(entry->m_key);
+        if(keys->second.empty()) {
+          m_tables.erase(keys);
+        }
+      }
+    }
+    --m_statistics.m_entries;
+    m_statistics.m_bytes -= entry->m_bytes;
+    m_index.erase(m_index.find(*entry->m_key));
+    m_entries.erase(entry);
+  }
+
+  template<typename C>
+  void CachedConnection<C>::evict() {
+    while(m_statistics.m_bytes > m_capacity && !m_entries.empty()) {
+      ++m_statistics.m_evictions;
+      erase(std::prev(m_entries.end()));
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,337 @@
+#ifndef VIPER_CONNECTION_POOL_HPP
+#define VIPER_CONNECTION_POOL_HPP
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Viper {
+
+  /*! \brief Shares a bounded number of connections among threads, opening
+             them on demand and closing them once they sit idle for too long.
+      \tparam C The type of connection to pool, providing <code>open()</code>,
+                <code>close()</code>, <code>bool ping()</code> and
+                <code>reset()</code>.
+   */
+  template<typename C>
+  class ConnectionPool {
+    public:
+
+      //! The type of connection to pool.
+      using Connection = C;
+
+      //! Builds an unopened connection.
+      using Factory = std::function<Connection ()>;
+
+      //! The number of buckets in the wait time histogram.
+      static constexpr auto WAIT_BUCKETS = std::size_t(24);
+
+      //! Stores counters measuring the pool's utilization.
+      struct Statistics {
+
+        //! The maximum number of connections.
+        std::size_t m_capacity = 0;
+
+        //! The number of open connections.
+        std::size_t m_size = 0;
+
+        //! The number of connections checked out.
+        std::size_t m_in_use = 0;
+
+        //! The largest number of connections checked out at once.
+        std::size_t m_peak_in_use = 0;
+
+        //! The number of connections checked out since construction.
+        std::uint64_t m_checkouts = 0;
+
+        //! The number of checkouts that waited for a connection to be
+        //! returned.
+        std::uint64_t m_waits = 0;
+
+        //! The number of connections opened.
+        std::uint64_t m_opens = 0;
+
+        //! The number of idle connections closed.
+        std::uint64_t m_evictions = 0;
+
+        //! The number of connections discarded because they failed a ping
+        //! or a reset.
+        std::uint64_t m_failures = 0;
+
+        //! The total time spent waiting to check out a connection.
+        std::chrono::nanoseconds m_total_wait{0};
+
+        //! Counts checkouts by the time they waited, bucket i counts waits
+        //! shorter than 2^i microseconds and the last bucket counts all
+        //! longer waits.
+        std::array<std::uint64_t, WAIT_BUCKETS> m_wait_histogram{};
+      };
+
+      //! Provides exclusive use of a pooled connection, returning it to the
+      //! pool when destroyed.
+      class Handle {
+        public:
+
+          //! Moves a handle.
+          Handle(Handle&& handle);
+
+          ~Handle();
+
+          //! Returns the connection.
+          Connection& operator *() const;
+
+          //! Returns the connection.
+          Connection* operator ->() const;
+
+        private:
+          friend class ConnectionPool;
+          ConnectionPool* m_pool;
+          std::unique_ptr<Connection> m_connection;
+
+          Handle(ConnectionPool& pool, std::unique_ptr<Connection> connection);
+          Handle(const Handle&) = delete;
+          Handle& operator =(const Handle&) = delete;
+      };
+
+      //! The time an idle connection is kept open by default.
+      static constexpr auto DEFAULT_IDLE_TIMEOUT = std::chrono::seconds(60);
+
+      //! The time a connection may sit idle before it is pinged by default.
+      static constexpr auto DEFAULT_PING_INTERVAL = std::chrono::seconds(5);
+
+      //! Constructs a pool without opening any connections.
+      /*!
+        \param capacity The maximum number of connections.
+        \param factory Builds the connections, which the pool opens.
+        \param idle_timeout The time an idle connection is kept open.
+        \param ping_interval The time a connection may sit idle before it is
+               pinged when checked out.
+      */
+      ConnectionPool(std::size_t capacity, Factory factory,
+        std::chrono::milliseconds idle_timeout = DEFAULT_IDLE_TIMEOUT,
+        std::chrono::milliseconds ping_interval = DEFAULT_PING_INTERVAL);
+
+      //! Closes all connections, every handle must be destroyed beforehand.
+      ~ConnectionPool();
+
+      //! Checks out a connection, waiting for one to be returned if all of
+      //! them are in use.
+      Handle acquire();
+
+      //! Returns the pool's counters.
+      Statistics get_statistics() const;
+
+    private:
+      struct Entry {
+        std::unique_ptr<Connection> m_connection;
+        std::chrono::steady_clock::time_point m_last_used;
+      };
+      std::size_t m_capacity;
+      Factory m_factory;
+      std::chrono::milliseconds m_idle_timeout;
+      std::chrono::milliseconds m_ping_interval;
+      mutable std::mutex m_mutex;
+      std::condition_variable m_available_condition;
+      std::vector<Entry> m_idle;
+      Statistics m_statistics;
+
+      ConnectionPool(const ConnectionPool&) = delete;
+      ConnectionPool& operator =(const ConnectionPool&) = delete;
+      void release(std::unique_ptr<Connection> connection);
+      void evict(std::unique_lock<std::mutex>& lock,
+        std::chrono::steady_clock::time_point now);
+      void discard(std::unique_ptr<Connection> connection);
+      void record_checkout(std::chrono::steady_clock::duration wait);
+  };
+
+  template<typename C>
+  ConnectionPool<C>::Handle::Handle(Handle&& handle)
+      : m_pool(handle.m_pool),
+        m_connection(std::move(handle.m_connection)) {}
+
+  template<typename C>
+  ConnectionPool<C>::Handle::~Handle() {
+    if(m_connection != nullptr) {
+      m_pool->release(std::move(m_connection));
+    }
+  }
+
+  template<typename C>
+  typename ConnectionPool<C>::Connection&
+      ConnectionPool<C>::Handle::operator *() const {
+    return *m_connection;
+  }
+
+  template<typename C>
+  typename ConnectionPool<C>::Connection*
+      ConnectionPool<C>::Handle::operator ->() const {
+    return m_connection.get();
+  }
+
+  template<typename C>
+  ConnectionPool<C>::Handle::Handle(ConnectionPool& pool,
+      std::unique_ptr<Connection> connection)
+      : m_pool(&pool),
+        m_connection(std::move(connection)) {}
+
+  template<typename C>
+  ConnectionPool<C>::ConnectionPool(std::size_t capacity, Factory factory,
+      std::chrono::milliseconds idle_timeout,
+      std::chrono::milliseconds ping_interval)
+      : m_capacity(std::max<std::size_t>(1, capacity)),
+        m_factory(std::move(factory)),
+        m_idle_timeout(idle_timeout),
+        m_ping_interval(ping_interval) {
+    m_statistics.m_capacity = m_capacity;
+  }
+
+  template<typename C>
+  ConnectionPool<C>::~ConnectionPool() {
+    for(auto& entry : m_idle) {
+      entry.m_connection->close();
+    }
+  }
+
+  template<typename C>
+  typename ConnectionPool<C>::Handle ConnectionPool<C>::acquire() {
+    auto start = std::chrono::steady_clock::now();
+    auto lock = std::unique_lock(m_mutex);
+    auto is_waiting = false;
+    while(true) {
+      auto now = std::chrono::steady_clock::now();
+      evict(lock, now);
+      if(!m_idle.empty()) {
+        auto entry = std::move(m_idle.back());
+        m_idle.pop_back();
+        ++m_statistics.m_in_use;
+        lock.unlock();
+        if(now - entry.m_last_used >= m_ping_interval &&
+            !entry.m_connection->ping()) {
+          discard(std::move(entry.m_connection));
+          lock.lock();
+          continue;
+        }
+        lock.lock();
+        record_checkout(std::chrono::steady_clock::now() - start);
+        return Handle(*this, std::move(entry.m_connection));
+      }
+      if(m_statistics.m_size < m_capacity) {
+        ++m_statistics.m_size;
+        ++m_statistics.m_in_use;
+        lock.unlock();
+        auto connection = std::unique_ptr<Connection>();
+        try {
+          connection = std::make_unique<Connection>(m_factory());
+          connection->open();
+        } catch(...) {
+          lock.lock();
+          --m_statistics.m_size;
+          --m_statistics.m_in_use;
+          lock.unlock();
+          m_available_condition.notify_one();
+          throw;
+        }
+        lock.lock();
+        ++m_statistics.m_opens;
+        record_checkout(std::chrono::steady_clock::now() - start);
+        return Handle(*this, std::move(connection));
+      }
+      if(!is_waiting) {
+        is_waiting = true;
+        ++m_statistics.m_waits;
+      }
+      m_available_condition.wait(lock);
+    }
+  }
+
+  template<typename C>
+  typename ConnectionPool<C>::Statistics
+      ConnectionPool<C>::get_statistics() const {
+    auto lock = std::lock_guard(m_mutex);
+    return m_statistics;
+  }
+
+  template<typename C>
+  void ConnectionPool<C>::release(std::unique_ptr<Connection> connection) {
+    try {
+      connection->reset();
+    } catch(...) {
+      discard(std::move(connection));
+      return;
+    }
+    {
+      auto lock = std::lock_guard(m_mutex);
+      --m_statistics.m_in_use;
+      m_idle.push_back(
+        Entry{std::move(connection), std::chrono::steady_clock::now()});
+    }
+    m_available_condition.notify_one();
+  }
+
+  template<typename C>
+  void ConnectionPool<C>::evict(std::unique_lock<std::mutex>& lock,
+      std::chrono::steady_clock::time_point now) {
+    auto expired = std::find_if(m_idle.begin(), m_idle.end(),
+      [&] (const auto& entry) {
+        return now - entry.m_last_used < m_idle_timeout;
+      });
+    if(expired == m_idle.begin()) {
+      return;
+    }
+    auto evictions = std::vector<Entry>(
+      std::make_move_iterator(m_idle.begin()),
+      std::make_move_iterator(expired));
+    m_idle.erase(m_idle.begin(), expired);
+    m_statistics.m_size -= evictions.size();
+    m_statistics.m_evictions += evictions.size();
+    lock.unlock();
+    for(auto& entry : evictions) {
+      try {
+        entry.m_connection->close();
+      } catch(...) {}
+    }
+    lock.lock();
+  }
+
+  template<typename C>
+  void ConnectionPool<C>::discard(std::unique_ptr<Connection> connection) {
+    try {
+      connection->close();
+    } catch(...) {}
+    {
+      auto lock = std::lock_guard(m_mutex);
+      --m_statistics.m_size;
+      --m_statistics.m_in_use;
+      ++m_statistics.m_failures;
+    }
+    m_available_condition.notify_one();
+  }
+
+  template<typename C>
+  void ConnectionPool<C>::record_checkout(
+      std::chrono::steady_clock::duration wait) {
+    auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(wait);
+    ++m_statistics.m_checkouts;
+    m_statistics.m_peak_in_use =
+      std::max(m_statistics.m_peak_in_use, m_statistics.m_in_use);
+    m_statistics.m_total_wait += nanoseconds;
+    auto microseconds = static_cast<std::uint64_t>(nanoseconds.count() / 1000);
+    auto bucket = std::size_t(0);
+    while(bucket != WAIT_BUCKETS - 1 &&
+        microseconds >= (std::uint64_t(1) << bucket)) {
+      ++bucket;
+    }
+    ++m_statistics.m_wait_histogram[bucket];
+  }
+}
+
+#endif
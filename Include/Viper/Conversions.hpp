@@ -1,10 +1,15 @@
 #ifndef VIPER_CONVERSIONS_HPP
 #define VIPER_CONVERSIONS_HPP
+#include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "Viper/DataTypes/BlobDataType.hpp"
 #include "Viper/DataTypes/DateTimeDataType.hpp"
@@ -15,13 +20,109 @@ namespace Viper {
   //! Stores the column in raw bytes.
   struct RawColumn {
 
+    //! Enumerates the representations a column can be stored in.
+    enum class Type {
+
+      //! The column is NULL.
+      NONE,
+
+      //! The column is text stored in m_data.
+      TEXT,
+
+      //! The column is binary data stored in m_data.
+      BLOB,
+
+      //! The column is an integer stored in m_integer.
+      INTEGER,
+
+      //! The column is a floating point number stored in m_real.
+      REAL,
+
+      //! The column is a DateTime whose ticks are stored in m_integer.
+      DATE_TIME
+    };
+
     //! The raw bytes encoding the value.
     const char* m_data;
 
     //! The size in bytes of the column.
     std::size_t m_size;
+
+    //! The representation of the column.
+    Type m_type = Type::TEXT;
+
+    //! The value of an integer or DateTime column.
+    std::int64_t m_integer = 0;
+
+    //! The value of a floating point column.
+    double m_real = 0;
   };
 
+  //! Returns <code>true</code> iff a raw column represents NULL.
+  inline bool is_null(const RawColumn& column) {
+    if(column.m_type == RawColumn::Type::TEXT ||
+        column.m_type == RawColumn::Type::BLOB) {
+      return column.m_data == nullptr;
+    }
+    return column.m_type == RawColumn::Type::NONE;
+  }
+
+namespace Details {
+  template<typename T>
+  bool from_native(const RawColumn& column, T& value) {
+    if(column.m_type == RawColumn::Type::INTEGER) {
+      value = static_cast<T>(column.m_integer);
+      return true;
+    } else if(column.m_type == RawColumn::Type::REAL) {
+      value = static_cast<T>(column.m_real);
+      return true;
+    }
+    return false;
+  }
+
+  template<typename T>
+  void append_number(T value, std::string& column) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    column.append(buffer, result.ptr);
+  }
+
+  //! Parses a numeric column, accepting leading whitespace and a leading '+'
+  //! as std::stod and std::stoi do, but rejecting any trailing characters.
+  template<typename T>
+  T parse_number(const RawColumn& column) {
+    auto first = column.m_data;
+    auto last = column.m_data + column.m_size;
+    while(first != last && std::isspace(static_cast<unsigned char>(*first))) {
+      ++first;
+    }
+    if(first != last && *first == '+' &&
+        (last - first == 1 || *(first + 1) != '-')) {
+      ++first;
+    }
+    auto value = T();
+    auto result = std::from_chars(first, last, value);
+    if(result.ec == std::errc::result_out_of_range) {
+      throw std::out_of_range("Numeric column out of range.");
+    } else if(result.ec != std::errc() || result.ptr != last) {
+      throw std::invalid_argument("Invalid numeric column.");
+    }
+    return value;
+  }
+
+  inline int parse_digits(const char* digits, int count) {
+    auto value = 0;
+    for(auto i = 0; i != count; ++i) {
+      auto digit = digits[i] - '0';
+      if(digit < 0 || digit > 9) {
+        throw std::invalid_argument("Invalid DateTime column.");
+      }
+      value = 10 * value + digit;
+    }
+    return value;
+  }
+}
+
   /*! \brief Callable data type used to convert a value to an SQL column.
       \tparam T The data type to convert.
    */
@@ -44,6 +145,23 @@ namespace Viper {
   template<typename T, typename = void>
   struct FromSql {};
 
+  /*! \brief Callable data type used to convert a value to a raw column.
+      \tparam T The data type to convert.
+   */
+  template<typename T, typename = void>
+  struct ToRawColumn {};
+
+  //! Converts a value to a raw column.
+  /*!
+    \param value The value to convert.
+    \param column The column to store the value in.
+    \param buffer Stores any bytes referenced by the <i>column</i>.
+  */
+  template<typename T>
+  void to_raw_column(const T& value, RawColumn& column, std::string& buffer) {
+    ToRawColumn<T>()(value, column, buffer);
+  }
+
   //! Converts a list of SQL columns to a value.
   /*!
     \param columns The columns to convert.
@@ -76,7 +194,9 @@ namespace Viper {
   template<>
   struct FromSql<bool> {
     auto operator ()(const RawColumn& column) const {
-      if(column.m_data[0] == '0') {
+      if(column.m_type == RawColumn::Type::INTEGER) {
+        return column.m_integer != 0;
+      } else if(column.m_size != 0 && column.m_data[0] == '0') {
         return false;
       }
       return true;
@@ -95,6 +215,9 @@ namespace Viper {
   template<>
   struct FromSql<char> {
     auto operator ()(const RawColumn& column) const {
+      if(column.m_size == 0) {
+        return '\0';
+      }
       return column.m_data[0];
     }
   };
@@ -102,118 +225,142 @@ namespace Viper {
   template<>
   struct ToSql<double> {
     void operator ()(double value, std::string& column) const {
-      column += std::to_string(value);
+      Details::append_number(value, column);
     }
   };
 
   template<>
   struct FromSql<double> {
-    auto operator ()(const RawColumn& column) const {
-      return std::stod(column.m_data);
+    double operator ()(const RawColumn& column) const {
+      if(auto value = double(); Details::from_native(column, value)) {
+        return value;
+      }
+      return Details::parse_number<double>(column);
     }
   };
 
   template<>
   struct ToSql<float> {
     void operator ()(float value, std::string& column) const {
-      column += std::to_string(value);
+      Details::append_number(value, column);
     }
   };
 
   template<>
   struct FromSql<float> {
-    auto operator ()(const RawColumn& column) const {
-      return std::stof(column.m_data);
+    float operator ()(const RawColumn& column) const {
+      if(auto value = float(); Details::from_native(column, value)) {
+        return value;
+      }
+      return Details::parse_number<float>(column);
     }
   };
 
   template<>
   struct ToSql<std::int16_t> {
     void operator ()(std::int16_t value, std::string& column) const {
-      column += std::to_string(value);
+      Details::append_number(value, column);
     }
   };
 
   template<>
   struct FromSql<std::int16_t> {
     std::int16_t operator ()(const RawColumn& column) const {
-      return std::stoi(column.m_data);
+      if(auto value = std::int16_t(); Details::from_native(column, value)) {
+        return value;
+      }
+      return Details::parse_number<std::int16_t>(column);
     }
   };
 
   template<>
   struct ToSql<std::uint16_t> {
     void operator ()(std::uint16_t value, std::string& column) const {
-      column += std::to_string(value);
+      Details::append_number(value, column);
     }
   };
 
   template<>
   struct FromSql<std::uint16_t> {
     std::uint16_t operator ()(const RawColumn& column) const {
-      return static_cast<std::uint16_t>(std::stoul(column.m_data));
+      if(auto value = std::uint16_t(); Details::from_native(column, value)) {
+        return value;
+      }
+      return Details::parse_number<std::uint16_t>(column);
     }
   };
 
   template<>
   struct ToSql<std::int32_t> {
     void operator ()(std::int32_t value, std::string& column) const {
-      column += std::to_string(value);
+      Details::append_number(value, column);
     }
   };
 
   template<>
   struct FromSql<std::int32_t> {
-    auto operator ()(const RawColumn& column) const {
-      return std::stoi(column.m_data);
+    std::int32_t operator ()(const RawColumn& column) const {
+      if(auto value = std::int32_t(); Details::from_native(column, value)) {
+        return value;
+      }
+      return Details::parse_number<std::int32_t>(column);
     }
   };
 
   template<>
   struct ToSql<std::uint32_t> {
     void operator ()(std::uint32_t value, std::string& column) const {
-      column += std::to_string(value);
+      Details::append_number(value, column);
     }
   };
 
   template<>
   struct FromSql<std::uint32_t> {
-    auto operator ()(const RawColumn& column) const {
-      return std::stoul(column.m_data);
+    std::uint32_t operator ()(const RawColumn& column) const {
+      if(auto value = std::uint32_t(); Details::from_native(column, value)) {
+        return value;
+      }
+      return Details::parse_number<std::uint32_t>(column);
     }
   };
 
   template<>
   struct ToSql<std::int64_t> {
     void operator ()(std::int64_t value, std::string& column) const {
-      column += std::to_string(value);
+      Details::append_number(value, column);
     }
   };
 
   template<>
   struct FromSql<std::int64_t> {
-    auto operator ()(const RawColumn& column) const {
-      return std::stoll(column.m_data);
+    std::int64_t operator ()(const RawColumn& column) const {
+      if(auto value = std::int64_t(); Details::from_native(column, value)) {
+        return value;
+      }
+      return Details::parse_number<std::int64_t>(column);
     }
   };
 
   template<>
   struct ToSql<std::uint64_t> {
     void operator ()(std::uint64_t value, std::string& column) const {
-      column += std::to_string(value);
+      Details::append_number(value, column);
     }
   };
 
   template<>
   struct FromSql<std::uint64_t> {
-    auto operator ()(const RawColumn& column) const {
-      return std::stoull(column.m_data);
+    std::uint64_t operator ()(const RawColumn& column) const {
+      if(auto value = std::uint64_t(); Details::from_native(column, value)) {
+        return value;
+      }
+      return Details::parse_number<std::uint64_t>(column);
     }
   };
 
   template<>
   struct ToSql<std::string> {
-    void operator ()(std::string value, std::string& column) const {
+    void operator ()(const std::string& value, std::string& column) const {
       escape(value, column);
     }
   };
@@ -221,7 +368,7 @@ namespace Viper {
   template<>
   struct FromSql<std::string> {
     auto operator ()(const RawColumn& column) const {
-      return std::string(column.m_data);
+      return std::string(column.m_data, column.m_size);
     }
   };
 
@@ -269,7 +416,7 @@ namespace Viper {
   template<typename T>
   struct FromSql<std::optional<T>> {
     std::optional<T> operator ()(const RawColumn& column) const {
-      if(column.m_data == nullptr) {
+      if(is_null(column)) {
         return std::nullopt;
       }
       return from_sql<T>(column);
@@ -293,30 +440,136 @@ namespace Viper {
   template<>
   struct ToSql<DateTime> {
     void operator ()(DateTime value, std::string& column) const {
-      column += to_string(value);
+      char buffer[DATE_TIME_CHARS];
+      column += '\'';
+      column.append(buffer, to_chars(buffer, value));
+      column += '\'';
     }
   };
 
   template<>
   struct FromSql<DateTime> {
     auto operator ()(const RawColumn& column) const {
-      auto year = 0;
-      auto month = 0;
-      auto day = 0;
-      auto hour = 0;
-      auto minute = 0;
-      auto second = 0;
+      if(column.m_type == RawColumn::Type::DATE_TIME) {
+        return DateTime(static_cast<std::uint64_t>(column.m_integer));
+      }
+      static constexpr auto SECONDS_SIZE = std::size_t(19);
+      if(column.m_size < SECONDS_SIZE) {
+        throw std::invalid_argument("Invalid DateTime column.");
+      }
+      auto& data = column.m_data;
+      auto year = Details::parse_digits(data, 4);
+      auto month = Details::parse_digits(data + 5, 2);
+      auto day = Details::parse_digits(data + 8, 2);
+      auto hour = Details::parse_digits(data + 11, 2);
+      auto minute = Details::parse_digits(data + 14, 2);
+      auto second = Details::parse_digits(data + 17, 2);
       auto fraction = 0;
-      if(column.m_data[19] == '\0') {
-        std::sscanf(column.m_data, "%d-%d-%d %d:%d:%d", &year, &month, &day,
-          &hour, &minute, &second);
-      } else {
-        std::sscanf(column.m_data, "%d-%d-%d %d:%d:%d.%d", &year, &month, &day,
-          &hour, &minute, &second, &fraction);
+      if(column.m_size > SECONDS_SIZE + 1) {
+        auto digits = std::min<int>(3,
+          static_cast<int>(column.m_size - SECONDS_SIZE - 1));
+        fraction = Details::parse_digits(data + SECONDS_SIZE + 1, digits);
       }
       return DateTime(year, month, day, hour, minute, second, fraction);
     }
   };
+  template<>
+  struct ToRawColumn<bool> {
+    void operator ()(bool value, RawColumn& column, std::string& buffer) const {
+      column.m_type = RawColumn::Type::INTEGER;
+      column.m_integer = value ? 1 : 0;
+    }
+  };
+
+  template<>
+  struct ToRawColumn<char> {
+    void operator ()(char value, RawColumn& column, std::string& buffer) const {
+      buffer.assign(1, value);
+      column.m_type = RawColumn::Type::TEXT;
+      column.m_data = buffer.data();
+      column.m_size = buffer.size();
+    }
+  };
+
+  template<typename T>
+  struct ToRawColumn<T, std::enable_if_t<std::is_integral_v<T>>> {
+    void operator ()(T value, RawColumn& column, std::string& buffer) const {
+      column.m_type = RawColumn::Type::INTEGER;
+      column.m_integer = static_cast<std::int64_t>(value);
+    }
+  };
+
+  template<typename T>
+  struct ToRawColumn<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    void operator ()(T value, RawColumn& column, std::string& buffer) const {
+      column.m_type = RawColumn::Type::REAL;
+      column.m_real = value;
+    }
+  };
+
+  template<>
+  struct ToRawColumn<std::string> {
+    void operator ()(const std::string& value, RawColumn& column,
+        std::string& buffer) const {
+      buffer.assign(value);
+      column.m_type = RawColumn::Type::TEXT;
+      column.m_data = buffer.data();
+      column.m_size = buffer.size();
+    }
+  };
+
+  template<std::size_t N>
+  struct ToRawColumn<char[N]> {
+    void operator ()(const char (&value)[N], RawColumn& column,
+        std::string& buffer) const {
+      buffer.assign(value);
+      column.m_type = RawColumn::Type::TEXT;
+      column.m_data = buffer.data();
+      column.m_size = buffer.size();
+    }
+  };
+
+  template<>
+  struct ToRawColumn<std::vector<std::byte>> {
+    void operator ()(const std::vector<std::byte>& value, RawColumn& column,
+        std::string& buffer) const {
+      buffer.assign(reinterpret_cast<const char*>(value.data()), value.size());
+      column.m_type = RawColumn::Type::BLOB;
+      column.m_data = buffer.data();
+      column.m_size = buffer.size();
+    }
+  };
+
+  template<typename T>
+  struct ToRawColumn<std::optional<T>> {
+    void operator ()(const std::optional<T>& value, RawColumn& column,
+        std::string& buffer) const {
+      if(value.has_value()) {
+        to_raw_column(*value, column, buffer);
+      } else {
+        column.m_type = RawColumn::Type::NONE;
+        column.m_data = nullptr;
+        column.m_size = 0;
+      }
+    }
+  };
+
+  template<typename T>
+  struct ToRawColumn<T, std::enable_if_t<std::is_enum_v<T>>> {
+    void operator ()(T value, RawColumn& column, std::string& buffer) const {
+      to_raw_column<std::int32_t>(static_cast<std::int32_t>(value), column,
+        buffer);
+    }
+  };
+
+  template<>
+  struct ToRawColumn<DateTime> {
+    void operator ()(DateTime value, RawColumn& column,
+        std::string& buffer) const {
+      column.m_type = RawColumn::Type::DATE_TIME;
+      column.m_integer = static_cast<std::int64_t>(value.get_ticks());
+    }
+  };
 }
 
 #endif
@@ -43,8 +43,8 @@ namespace Viper {
     \param row The table's row to create.
     \param name The name of the table.
   */
-  template<typename T>
-  auto create(Row<T> row, std::string name) {
+  template<typename T, typename = std::enable_if_t<is_row_v<T>>>
+  auto create(T row, std::string name) {
     return CreateTableStatement(std::move(row), std::move(name), false);
   }
 
@@ -53,8 +53,8 @@ namespace Viper {
     \param row The table's row to create.
     \param name The name of the table.
   */
-  template<typename T>
-  auto create_if_not_exists(Row<T> row, std::string name) {
+  template<typename T, typename = std::enable_if_t<is_row_v<T>>>
+  auto create_if_not_exists(T row, std::string name) {
     return CreateTableStatement(std::move(row), std::move(name), true);
   }
 
@@ -0,0 +1,188 @@
+#ifndef VIPER_CURSOR_HPP
+#define VIPER_CURSOR_HPP
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace Viper {
+
+  /*! \brief Iterates over the rows of a query, fetching each row only once
+             the previous one has been consumed.
+      \tparam R The type of row to select.
+      \tparam S The source of rows, providing <code>bool fetch()</code> to
+                advance to the next row and <code>get_columns()</code> to
+                access its raw columns.
+   */
+  template<typename R, typename S>
+  class Cursor {
+    public:
+
+      //! The type of row to select.
+      using Row = R;
+
+      //! The source the rows are fetched from.
+      using Source = S;
+
+      //! The type used to represent a row.
+      using Type = typename Row::Type;
+
+      //! Provides single pass iteration over a cursor's rows.
+      class Iterator {
+        public:
+          using iterator_category = std::input_iterator_tag;
+          using value_type = Type;
+          using difference_type = std::ptrdiff_t;
+          using pointer = Type*;
+          using reference = Type&;
+
+          //! Constructs an iterator past the last row.
+          Iterator();
+
+          //! Constructs an iterator positioned on a cursor's current row.
+          /*!
+            \param cursor The cursor to iterate over.
+          */
+          explicit Iterator(Cursor& cursor);
+
+          //! Returns the current row.
+          Type& operator *() const;
+
+          //! Returns the current row.
+          Type* operator ->() const;
+
+          //! Fetches the next row.
+          Iterator& operator ++();
+
+          //! Tests if two iterators are at the same position.
+          bool operator ==(const Iterator& rhs) const;
+
+          //! Tests if two iterators are at different positions.
+          bool operator !=(const Iterator& rhs) const;
+
+        private:
+          Cursor* m_cursor;
+
+          bool is_end() const;
+      };
+
+      //! Constructs a cursor.
+      /*!
+        \param row The type of row to select.
+        \param source The executed query to fetch rows from.
+      */
+      Cursor(Row row, Source source);
+
+      //! Moves a cursor, iterators over the moved cursor are invalidated.
+      Cursor(Cursor&& cursor) = default;
+
+      //! Fetches the next row.
+      /*!
+        \return <code>true</code> iff a row was fetched.
+      */
+      bool next();
+
+      //! Returns the most recently fetched row.
+      Type& get();
+
+      //! Returns an iterator positioned on the current row, fetching the
+      //! first row if none has been fetched yet.
+      Iterator begin();
+
+      //! Returns an iterator past the last row.
+      Iterator end();
+
+    private:
+      Row m_row;
+      Source m_source;
+      Type m_value;
+      bool m_is_started;
+      bool m_is_done;
+
+      Cursor(const Cursor&) = delete;
+      Cursor& operator =(const Cursor&) = delete;
+  };
+
+  template<typename R, typename S>
+  Cursor<R, S>::Iterator::Iterator()
+      : m_cursor(nullptr) {}
+
+  template<typename R, typename S>
+  Cursor<R, S>::Iterator::Iterator(Cursor& cursor)
+      : m_cursor(&cursor) {}
+
+  template<typename R, typename S>
+  typename Cursor<R, S>::Type& Cursor<R, S>::Iterator::operator *() const {
+    return m_cursor->get();
+  }
+
+  template<typename R, typename S>
+  typename Cursor<R, S>::Type* Cursor<R, S>::Iterator::operator ->() const {
+    return &m_cursor->get();
+  }
+
+  template<typename R, typename S>
+  typename Cursor<R, S>::Iterator& Cursor<R, S>::Iterator::operator ++() {
+    m_cursor->next();
+    return *this;
+  }
+
+  template<typename R, typename S>
+  bool Cursor<R, S>::Iterator::operator ==(const Iterator& rhs) const {
+    if(is_end() || rhs.is_end()) {
+      return is_end() == rhs.is_end();
+    }
+    return m_cursor == rhs.m_cursor;
+  }
+
+  template<typename R, typename S>
+  bool Cursor<R, S>::Iterator::operator !=(const Iterator& rhs) const {
+    return !(*this == rhs);
+  }
+
+  template<typename R, typename S>
+  bool Cursor<R, S>::Iterator::is_end() const {
+    return m_cursor == nullptr || m_cursor->m_is_done;
+  }
+
+  template<typename R, typename S>
+  Cursor<R, S>::Cursor(Row row, Source source)
+      : m_row(std::move(row)),
+        m_source(std::move(source)),
+        m_value(),
+        m_is_started(false),
+        m_is_done(false) {}
+
+  template<typename R, typename S>
+  bool Cursor<R, S>::next() {
+    m_is_started = true;
+    if(m_is_done) {
+      return false;
+    }
+    if(!m_source.fetch()) {
+      m_is_done = true;
+      return false;
+    }
+    m_row.extract(m_source.get_columns(), m_value);
+    return true;
+  }
+
+  template<typename R, typename S>
+  typename Cursor<R, S>::Type& Cursor<R, S>::get() {
+    return m_value;
+  }
+
+  template<typename R, typename S>
+  typename Cursor<R, S>::Iterator Cursor<R, S>::begin() {
+    if(!m_is_started) {
+      next();
+    }
+    return Iterator(*this);
+  }
+
+  template<typename R, typename S>
+  typename Cursor<R, S>::Iterator Cursor<R, S>::end() {
+    return Iterator();
+  }
+}
+
+#endif
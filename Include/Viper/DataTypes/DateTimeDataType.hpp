@@ -1,10 +1,9 @@
 #ifndef VIPER_DATE_TIME_DATA_TYPE_HPP
 #define VIPER_DATE_TIME_DATA_TYPE_HPP
-#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include <string>
-#include <time.h>
 #include "Viper/DataTypes/DataType.hpp"
 
 namespace Viper {
@@ -22,7 +21,7 @@ namespace Viper {
       //! Constructs a DateTime to a specified point in time.
       /*!
         \param year The year to represent.
-        \param month The month [0-11].
+        \param month The month [1-12].
         \param day The day of month [1-31].
         \param hour The number of hours since midnight [0-23].
         \param minute The number of minutes since the hour [0-59].
@@ -32,6 +31,12 @@ namespace Viper {
       DateTime(int year, int month, int day, int hour, int minute, int second,
         int milliseconds);
 
+      //! Constructs a DateTime from a number of ticks since the epoch.
+      /*!
+        \param ticks The number of ticks since January 1, 1970.
+      */
+      explicit DateTime(std::uint64_t ticks);
+
       //! Returns the number of ticks used to represent this DateTime.
       std::uint64_t get_ticks() const;
 
@@ -59,26 +64,31 @@ namespace Viper {
   //! Date/time data type.
   static inline auto date_time = DateTimeDataType();
 
+  //! The maximum number of characters written by to_chars.
+  static constexpr auto DATE_TIME_CHARS = std::size_t(23);
+
+  //! Writes a DateTime as unquoted text of the form
+  //! <code>YYYY-MM-DD HH:MM:SS[.mmm]</code>.
+  /*!
+    \param first The buffer to write to, it must have room for at least
+           DATE_TIME_CHARS characters.
+    \param date_time The DateTime to write.
+    \return A pointer one past the last character written.
+  */
+  char* to_chars(char* first, DateTime date_time);
+
   //! Converts a DateTime to a string.
   /*!
     \param date_time The DateTime to convert.
     \return The string representation suitable for storing in SQL.
   */
   inline std::string to_string(DateTime date_time) {
-    auto buffer = std::string();
-    buffer = '\'';
-    buffer.resize(21);
-    auto delta = std::time_t(
-      date_time.get_ticks() / DateTime::TICKS_PER_SECOND);
-    std::strftime(&buffer[1], 20, "%Y-%m-%d %H:%M:%S", std::gmtime(&delta));
-    auto fraction = date_time.get_ticks() - DateTime::TICKS_PER_SECOND * delta;
-    buffer.pop_back();
-    if(fraction != 0) {
-      buffer += '.';
-      buffer += std::to_string(fraction);
-    }
-    buffer += '\'';
-    return buffer;
+    char buffer[DATE_TIME_CHARS + 2];
+    buffer[0] = '\'';
+    auto last = to_chars(buffer + 1, date_time);
+    *last = '\'';
+    ++last;
+    return std::string(buffer, last);
   }
 
   //! Converts a DateTime to a std::tm struct.
@@ -86,34 +96,123 @@ namespace Viper {
     \param date_time The DateTime to convert.
     \return The std::tm representation of the <i>date_time</i>.
   */
-  inline std::tm to_tm(DateTime date_time) {
-    auto tm = std::time_t(
-      date_time.get_ticks() / DateTime::TICKS_PER_SECOND);
-    return *std::gmtime(&tm);
+  std::tm to_tm(DateTime date_time);
+
+namespace Details {
+  static constexpr auto SECONDS_PER_DAY = std::int64_t(86400);
+
+  inline std::int64_t floor_divide(std::int64_t numerator,
+      std::int64_t denominator) {
+    auto quotient = numerator / denominator;
+    if(numerator % denominator < 0) {
+      --quotient;
+    }
+    return quotient;
   }
 
-  inline DateTime::DateTime()
-      : m_ticks(0) {}
+  inline std::int64_t days_from_civil(int year, int month, int day) {
+    auto y = static_cast<std::int64_t>(year) - (month <= 2);
+    auto era = floor_divide(y, 400);
+    auto year_of_era = y - era * 400;
+    auto day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 +
+      day - 1;
+    auto day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 +
+      day_of_year;
+    return era * 146097 + day_of_era - 719468;
+  }
 
-  inline DateTime::DateTime(int year, int month, int day, int hour, int minute,
-      int second, int milliseconds) {
+  inline void civil_from_days(std::int64_t days, int& year, int& month,
+      int& day) {
+    days += 719468;
+    auto era = floor_divide(days, 146097);
+    auto day_of_era = days - era * 146097;
+    auto year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 -
+      day_of_era / 146096) / 365;
+    auto day_of_year = day_of_era -
+      (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    auto month_index = (5 * day_of_year + 2) / 153;
+    day = static_cast<int>(day_of_year - (153 * month_index + 2) / 5 + 1);
+    month = static_cast<int>(month_index < 10 ? month_index + 3 :
+      month_index - 9);
+    year = static_cast<int>(year_of_era + era * 400 + (month <= 2));
+  }
+
+  inline char* write_digits(char* first, int value, int count) {
+    for(auto i = count - 1; i >= 0; --i) {
+      first[i] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    }
+    return first + count;
+  }
+}
+
+  inline char* to_chars(char* first, DateTime date_time) {
+    auto ticks = static_cast<std::int64_t>(date_time.get_ticks());
+    auto seconds = Details::floor_divide(ticks, DateTime::TICKS_PER_SECOND);
+    auto fraction = static_cast<int>(
+      ticks - seconds * DateTime::TICKS_PER_SECOND);
+    auto days = Details::floor_divide(seconds, Details::SECONDS_PER_DAY);
+    auto time_of_day = static_cast<int>(
+      seconds - days * Details::SECONDS_PER_DAY);
+    auto year = 0;
+    auto month = 0;
+    auto day = 0;
+    Details::civil_from_days(days, year, month, day);
+    first = Details::write_digits(first, year, 4);
+    *first++ = '-';
+    first = Details::write_digits(first, month, 2);
+    *first++ = '-';
+    first = Details::write_digits(first, day, 2);
+    *first++ = ' ';
+    first = Details::write_digits(first, time_of_day / 3600, 2);
+    *first++ = ':';
+    first = Details::write_digits(first, (time_of_day / 60) % 60, 2);
+    *first++ = ':';
+    first = Details::write_digits(first, time_of_day % 60, 2);
+    if(fraction != 0) {
+      *first++ = '.';
+      first = Details::write_digits(first, fraction, 3);
+    }
+    return first;
+  }
+
+  inline std::tm to_tm(DateTime date_time) {
+    auto seconds = Details::floor_divide(
+      static_cast<std::int64_t>(date_time.get_ticks()),
+      DateTime::TICKS_PER_SECOND);
+    auto days = Details::floor_divide(seconds, Details::SECONDS_PER_DAY);
+    auto time_of_day = static_cast<int>(
+      seconds - days * Details::SECONDS_PER_DAY);
+    auto year = 0;
+    auto month = 0;
+    auto day = 0;
+    Details::civil_from_days(days, year, month, day);
     auto tm = std::tm();
     tm.tm_year = year - 1900;
     tm.tm_mon = month - 1;
     tm.tm_mday = day;
-    tm.tm_hour = hour;
-    tm.tm_min = minute;
-    tm.tm_sec = second;
-    tm.tm_isdst = -1;
-#ifdef _MSC_VER
-    m_ticks = TICKS_PER_SECOND * static_cast<std::uint64_t>(
-      ::_mkgmtime(&tm)) + milliseconds;
-#else
-    m_ticks = TICKS_PER_SECOND * static_cast<std::uint64_t>(::timegm(&tm)) +
-      milliseconds;
-#endif
+    tm.tm_hour = time_of_day / 3600;
+    tm.tm_min = (time_of_day / 60) % 60;
+    tm.tm_sec = time_of_day % 60;
+    tm.tm_wday = static_cast<int>(
+      days + 4 - 7 * Details::floor_divide(days + 4, 7));
+    tm.tm_yday = static_cast<int>(days - Details::days_from_civil(year, 1, 1));
+    return tm;
   }
 
+  inline DateTime::DateTime()
+      : m_ticks(0) {}
+
+  inline DateTime::DateTime(int year, int month, int day, int hour, int minute,
+      int second, int milliseconds)
+      : m_ticks(static_cast<std::uint64_t>(TICKS_PER_SECOND * (
+          Details::SECONDS_PER_DAY *
+          Details::days_from_civil(year, month, day) + 3600 * hour +
+          60 * minute + second) + milliseconds)) {}
+
+  inline DateTime::DateTime(std::uint64_t ticks)
+      : m_ticks(ticks) {}
+
   inline std::uint64_t DateTime::get_ticks() const {
     return m_ticks;
   }
@@ -20,6 +20,9 @@ namespace Viper {
       */
       Expression(std::shared_ptr<VirtualExpression> e);
 
+      //! Returns the encapsulated polymorphic value.
+      const std::shared_ptr<VirtualExpression>& get_virtual_expression() const;
+
       //! Appends this expression to an SQL query string.
       void append_query(std::string& query) const;
 
@@ -30,6 +33,11 @@ namespace Viper {
   inline Expression::Expression(std::shared_ptr<VirtualExpression> e)
       : m_expression(std::move(e)) {}
 
+  inline const std::shared_ptr<VirtualExpression>&
+      Expression::get_virtual_expression() const {
+    return m_expression;
+  }
+
   inline void Expression::append_query(std::string& query) const {
     if(!m_expression) {
       return;
@@ -1,10 +1,13 @@
 #ifndef VIPER_EXPRESSIONS_HPP
 #define VIPER_EXPRESSIONS_HPP
 #include "Viper/Expressions/Expression.hpp"
+#include "Viper/Expressions/InExpression.hpp"
 #include "Viper/Expressions/InfixOperator.hpp"
+#include "Viper/Expressions/JunctionOperator.hpp"
 #include "Viper/Expressions/LiteralExpression.hpp"
 #include "Viper/Expressions/MembershipOperator.hpp"
 #include "Viper/Expressions/NotExpression.hpp"
+#include "Viper/Expressions/ParameterExpression.hpp"
 #include "Viper/Expressions/SqlFunctions.hpp"
 #include "Viper/Expressions/SymbolExpression.hpp"
 #include "Viper/Expressions/VirtualExpression.hpp"
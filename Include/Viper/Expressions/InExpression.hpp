@@ -0,0 +1,222 @@
+#ifndef VIPER_IN_EXPRESSION_HPP
+#define VIPER_IN_EXPRESSION_HPP
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Viper/Conversions.hpp"
+#include "Viper/Expressions/Expression.hpp"
+
+namespace Viper {
+
+  //! Keeps the tables holding a query's staged key sets reserved for as long
+  //! as the query may read them.
+  using KeySetLease = std::shared_ptr<void>;
+
+  //! Collects the large key sets of the IN expressions in a query as it is
+  //! built, and once a connection has staged them, renders each one as a
+  //! subquery instead of as a list of literals.
+  class KeySetScope {
+    public:
+
+      //! Installs a scope on the current thread, restoring the previous one
+      //! when destroyed.
+      /*!
+        \param threshold The smallest number of keys to collect.
+      */
+      explicit KeySetScope(std::size_t threshold);
+
+      ~KeySetScope();
+
+      //! Returns the key sets collected so far, in order of appearance.
+      const std::vector<const std::vector<RawColumn>*>& get_key_sets() const;
+
+      //! Sets the subqueries rendered in place of the collected key sets.
+      /*!
+        \param subqueries One subquery per collected key set, in the same
+               order.
+      */
+      void set_subqueries(std::vector<std::string> subqueries);
+
+      //! Appends the subquery standing in for a set of keys, or collects the
+      //! keys if no subqueries have been set.
+      /*!
+        \param keys The keys to render.
+        \param query The query string to append the subquery to.
+        \return <code>true</code> iff a subquery was appended, otherwise the
+                keys are rendered as a list of literals.
+      */
+      bool append_key_set(const std::vector<RawColumn>& keys,
+        std::string& query);
+
+      //! Returns the scope installed on the current thread, if any.
+      static KeySetScope* get_scope();
+
+    private:
+      static inline thread_local KeySetScope* m_scope = nullptr;
+      KeySetScope* m_previous;
+      std::size_t m_threshold;
+      std::vector<const std::vector<RawColumn>*> m_key_sets;
+      std::vector<std::string> m_subqueries;
+
+      KeySetScope(const KeySetScope&) = delete;
+      KeySetScope& operator =(const KeySetScope&) = delete;
+  };
+
+  //! Implements an SQL expression testing whether a term is one of a set of
+  //! values.
+  class InExpression final : public VirtualExpression {
+    public:
+
+      //! Constructs an IN expression.
+      /*!
+        \param term The term to test.
+        \param values The range of values to test the term against.
+      */
+      template<typename R>
+      InExpression(Expression term, R&& values);
+
+      //! Returns the term to test.
+      const Expression& get_term() const;
+
+      //! Returns the values tested against, referencing bytes owned by this
+      //! expression.
+      const std::vector<RawColumn>& get_keys() const;
+
+      void append_query(std::string& query) const override;
+
+    private:
+      Expression m_term;
+      std::vector<RawColumn> m_keys;
+      std::string m_bytes;
+      std::string m_list;
+  };
+
+  //! Returns an expression testing whether a term is one of a range of
+  //! values. Small ranges are rendered as a list of literals, large ranges
+  //! may be staged by the connection executing the query.
+  /*!
+    \param term The term to test.
+    \param values The range of values to test the term against.
+  */
+  template<typename R,
+    typename = std::enable_if_t<std::ranges::input_range<R>>>
+  Expression in(Expression term, R&& values) {
+    return Expression(std::make_shared<InExpression>(std::move(term),
+      std::forward<R>(values)));
+  }
+
+  //! Returns an expression testing whether a term is one of a list of
+  //! values.
+  /*!
+    \param term The term to test.
+    \param values The values to test the term against.
+  */
+  template<typename T>
+  Expression in(Expression term, std::initializer_list<T> values) {
+    return Expression(std::make_shared<InExpression>(std::move(term),
+      values));
+  }
+
+  inline KeySetScope::KeySetScope(std::size_t threshold)
+      : m_previous(m_scope),
+        m_threshold(threshold) {
+    m_scope = this;
+  }
+
+  inline KeySetScope::~KeySetScope() {
+    m_scope = m_previous;
+  }
+
+  inline const std::vector<const std::vector<RawColumn>*>&
+      KeySetScope::get_key_sets() const {
+    return m_key_sets;
+  }
+
+  inline void KeySetScope::set_subqueries(
+      std::vector<std::string> subqueries) {
+    m_subqueries = std::move(subqueries);
+  }
+
+  inline bool KeySetScope::append_key_set(const std::vector<RawColumn>& keys,
+      std::string& query) {
+    if(keys.size() < m_threshold) {
+      return false;
+    }
+    auto key_set = std::find(m_key_sets.begin(), m_key_sets.end(), &keys);
+    if(m_subqueries.empty()) {
+      if(key_set == m_key_sets.end()) {
+        m_key_sets.push_back(&keys);
+      }
+      return false;
+    }
+    auto index = static_cast<std::size_t>(key_set - m_key_sets.begin());
+    if(index >= m_subqueries.size()) {
+      return false;
+    }
+    query += m_subqueries[index];
+    return true;
+  }
+
+  inline KeySetScope* KeySetScope::get_scope() {
+    return m_scope;
+  }
+
+  template<typename R>
+  InExpression::InExpression(Expression term, R&& values)
+      : m_term(std::move(term)) {
+    auto column = RawColumn();
+    auto buffer = std::string();
+    auto offsets = std::vector<std::size_t>();
+    for(auto&& value : values) {
+      if(!m_keys.empty()) {
+        m_list += ',';
+      }
+      to_sql(value, m_list);
+      to_raw_column(value, column, buffer);
+      if((column.m_type == RawColumn::Type::TEXT ||
+          column.m_type == RawColumn::Type::BLOB) && column.m_data != nullptr) {
+        offsets.push_back(m_bytes.size());
+        m_bytes.append(column.m_data, column.m_size);
+      } else {
+        offsets.push_back(std::string::npos);
+      }
+      m_keys.push_back(column);
+    }
+    for(auto i = std::size_t(0); i != m_keys.size(); ++i) {
+      if(offsets[i] != std::string::npos) {
+        m_keys[i].m_data = m_bytes.data() + offsets[i];
+      }
+    }
+  }
+
+  inline const Expression& InExpression::get_term() const {
+    return m_term;
+  }
+
+  inline const std::vector<RawColumn>& InExpression::get_keys() const {
+    return m_keys;
+  }
+
+  inline void InExpression::append_query(std::string& query) const {
+    if(m_keys.empty()) {
+      query += "(1 = 0)";
+      return;
+    }
+    query += '(';
+    m_term.append_query(query);
+    query += " IN (";
+    auto scope = KeySetScope::get_scope();
+    if(scope == nullptr || !scope->append_key_set(m_keys, query)) {
+      query += m_list;
+    }
+    query += "))";
+  }
+}
+
+#endif
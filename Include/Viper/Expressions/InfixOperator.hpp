@@ -2,6 +2,7 @@
 #define VIPER_INFIX_OPERATOR_HPP
 #include <stdexcept>
 #include "Viper/Expressions/Expression.hpp"
+#include "Viper/Expressions/JunctionOperator.hpp"
 #include "Viper/Expressions/LiteralExpression.hpp"
 
 namespace Viper {
@@ -441,8 +442,8 @@ namespace Viper {
     \param right The right hand side.
   */
   inline Expression operator &&(Expression left, Expression right) {
-    return Expression(std::make_shared<InfixOperator>(
-      InfixOperator::Type::AND, std::move(left), std::move(right)));
+    return join(JunctionOperator::Type::AND, std::move(left),
+      std::move(right));
   }
 
   //! Returns an expression representing logical and.
@@ -452,8 +453,7 @@ namespace Viper {
   */
   template<typename T>
   Expression operator &&(Expression left, const T& right) {
-    return Expression(std::make_shared<InfixOperator>(
-      InfixOperator::Type::AND, std::move(left), literal(right)));
+    return join(JunctionOperator::Type::AND, std::move(left), literal(right));
   }
 
   //! Returns an expression representing logical and.
@@ -463,8 +463,7 @@ namespace Viper {
   */
   template<typename T>
   Expression operator &&(const T& left, Expression right) {
-    return Expression(std::make_shared<InfixOperator>(
-      InfixOperator::Type::AND, literal(left), std::move(right)));
+    return join(JunctionOperator::Type::AND, literal(left), std::move(right));
   }
 
   //! Returns an expression representing logical or.
@@ -473,8 +472,7 @@ namespace Viper {
     \param right The right hand side.
   */
   inline Expression operator ||(Expression left, Expression right) {
-    return Expression(std::make_shared<InfixOperator>(InfixOperator::Type::OR,
-      std::move(left), std::move(right)));
+    return join(JunctionOperator::Type::OR, std::move(left), std::move(right));
   }
 
   //! Returns an expression representing logical or.
@@ -484,8 +482,7 @@ namespace Viper {
   */
   template<typename T>
   Expression operator ||(Expression left, const T& right) {
-    return Expression(std::make_shared<InfixOperator>(InfixOperator::Type::OR,
-      std::move(left), literal(right)));
+    return join(JunctionOperator::Type::OR, std::move(left), literal(right));
   }
 
   //! Returns an expression representing logical or.
@@ -495,8 +492,7 @@ namespace Viper {
   */
   template<typename T>
   Expression operator ||(const T& left, Expression right) {
-    return Expression(std::make_shared<InfixOperator>(InfixOperator::Type::OR,
-      literal(left), std::move(right)));
+    return join(JunctionOperator::Type::OR, literal(left), std::move(right));
   }
 
   inline InfixOperator::InfixOperator(Type t, Expression left,
@@ -508,7 +504,9 @@ namespace Viper {
   inline void InfixOperator::append_query(std::string& query) const {
     query += '(';
     m_left.append_query(query);
-    query += " " + get_symbol(m_type) + " ";
+    query += ' ';
+    query += get_symbol(m_type);
+    query += ' ';
     m_right.append_query(query);
     query += ')';
   }
@@ -0,0 +1,168 @@
+#ifndef VIPER_JUNCTION_OPERATOR_HPP
+#define VIPER_JUNCTION_OPERATOR_HPP
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Viper/Expressions/Expression.hpp"
+
+namespace Viper {
+
+  //! Implements an SQL expression joining any number of operands with AND or
+  //! with OR, so that long chains of conditions are stored and rendered
+  //! without nesting.
+  class JunctionOperator final : public VirtualExpression {
+    public:
+
+      //! Enumerates the types of junctions.
+      enum class Type {
+
+        //! operand AND operand AND ...
+        AND,
+
+        //! operand OR operand OR ...
+        OR
+      };
+
+      //! Constructs a junction.
+      /*!
+        \param type The operation joining the operands.
+        \param operands The operands to join.
+      */
+      JunctionOperator(Type type, std::vector<Expression> operands);
+
+      //! Destroys the operands without recursing into nested junctions.
+      ~JunctionOperator() override;
+
+      //! Returns the operation joining the operands.
+      Type get_type() const;
+
+      //! Returns the operands.
+      const std::vector<Expression>& get_operands() const;
+
+      void append_query(std::string& query) const override;
+
+    private:
+      friend Expression join(Type type, Expression left, Expression right);
+      Type m_type;
+      std::vector<Expression> m_operands;
+  };
+
+  //! Returns the symbol used to represent a junction.
+  inline const std::string& get_symbol(JunctionOperator::Type t) {
+    if(t == JunctionOperator::Type::AND) {
+      static const auto SYMBOL = std::string("AND");
+      return SYMBOL;
+    }
+    static const auto SYMBOL = std::string("OR");
+    return SYMBOL;
+  }
+
+  //! Joins two expressions, flattening either side that is itself a junction
+  //! of the same type. A left hand side that is not shared with any other
+  //! expression is extended in place, so that a chain of n operands is built
+  //! in amortized linear time.
+  /*!
+    \param type The operation joining the operands.
+    \param left The left hand side.
+    \param right The right hand side.
+  */
+  inline Expression join(JunctionOperator::Type type, Expression left,
+      Expression right) {
+    auto as_junction = [&] (const Expression& expression) {
+      auto junction = dynamic_cast<JunctionOperator*>(
+        expression.get_virtual_expression().get());
+      if(junction != nullptr && junction->m_type == type) {
+        return junction;
+      }
+      return static_cast<JunctionOperator*>(nullptr);
+    };
+    auto append = [&] (std::vector<Expression>& operands, Expression operand) {
+      if(auto junction = as_junction(operand)) {
+        operands.insert(operands.end(), junction->m_operands.begin(),
+          junction->m_operands.end());
+      } else {
+        operands.push_back(std::move(operand));
+      }
+    };
+    auto left_junction = as_junction(left);
+    if(left_junction != nullptr &&
+        left.get_virtual_expression().use_count() == 1) {
+      append(left_junction->m_operands, std::move(right));
+      return left;
+    }
+    auto operands = std::vector<Expression>();
+    append(operands, std::move(left));
+    append(operands, std::move(right));
+    return Expression(
+      std::make_shared<JunctionOperator>(type, std::move(operands)));
+  }
+
+  inline JunctionOperator::JunctionOperator(Type type,
+      std::vector<Expression> operands)
+      : m_type(type),
+        m_operands(std::move(operands)) {}
+
+  inline JunctionOperator::~JunctionOperator() {
+    auto pending = std::move(m_operands);
+    while(!pending.empty()) {
+      auto operand = std::move(pending.back());
+      pending.pop_back();
+      if(operand.get_virtual_expression().use_count() == 1) {
+        if(auto junction = dynamic_cast<JunctionOperator*>(
+            operand.get_virtual_expression().get())) {
+          std::move(junction->m_operands.begin(), junction->m_operands.end(),
+            std::back_inserter(pending));
+          junction->m_operands.clear();
+        }
+      }
+    }
+  }
+
+  inline JunctionOperator::Type JunctionOperator::get_type() const {
+    return m_type;
+  }
+
+  inline const std::vector<Expression>&
+      JunctionOperator::get_operands() const {
+    return m_operands;
+  }
+
+  inline void JunctionOperator::append_query(std::string& query) const {
+    struct Frame {
+      const JunctionOperator* m_junction;
+      std::size_t m_index;
+    };
+    auto frames = std::vector<Frame>();
+    frames.push_back(Frame{this, 0});
+    query += '(';
+    while(!frames.empty()) {
+      auto& frame = frames.back();
+      auto& operands = frame.m_junction->m_operands;
+      if(frame.m_index == operands.size()) {
+        query += ')';
+        frames.pop_back();
+        continue;
+      }
+      if(frame.m_index != 0) {
+        query += ' ';
+        query += get_symbol(frame.m_junction->m_type);
+        query += ' ';
+      }
+      auto& operand = operands[frame.m_index];
+      ++frame.m_index;
+      if(auto junction = dynamic_cast<const JunctionOperator*>(
+          operand.get_virtual_expression().get())) {
+        query += '(';
+        frames.push_back(Frame{junction, 0});
+      } else {
+        operand.append_query(query);
+      }
+    }
+  }
+}
+
+#endif
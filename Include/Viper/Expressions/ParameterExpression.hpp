@@ -0,0 +1,31 @@
+#ifndef VIPER_PARAMETER_EXPRESSION_HPP
+#define VIPER_PARAMETER_EXPRESSION_HPP
+#include <memory>
+#include <string>
+#include "Viper/Expressions/Expression.hpp"
+
+namespace Viper {
+
+  //! Implements an SQL expression representing a placeholder whose value is
+  //! bound when a prepared statement is executed. Parameters are positional,
+  //! values are bound in the order the placeholders appear in the query.
+  class ParameterExpression final : public VirtualExpression {
+    public:
+
+      //! Constructs a parameter expression.
+      ParameterExpression() = default;
+
+      void append_query(std::string& query) const override;
+  };
+
+  //! Makes a parameter expression.
+  inline Expression param() {
+    return Expression(std::make_shared<ParameterExpression>());
+  }
+
+  inline void ParameterExpression::append_query(std::string& query) const {
+    query += '?';
+  }
+}
+
+#endif
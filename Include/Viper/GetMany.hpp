@@ -0,0 +1,282 @@
+#ifndef VIPER_GET_MANY_HPP
+#define VIPER_GET_MANY_HPP
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Viper/BatchLimits.hpp"
+#include "Viper/Conversions.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/SelectStatement.hpp"
+#include "Viper/Expressions/Expressions.hpp"
+
+namespace Viper {
+namespace Details {
+  template<typename T>
+  struct is_tuple : std::false_type {};
+
+  template<typename... T>
+  struct is_tuple<std::tuple<T...>> : std::true_type {};
+
+  template<typename T1, typename T2>
+  struct is_tuple<std::pair<T1, T2>> : std::true_type {};
+
+  template<typename T>
+  constexpr auto is_tuple_v = is_tuple<T>::value;
+
+  inline bool append_key(const RawColumn& column, std::string& key) {
+    if(is_null(column)) {
+      return false;
+    }
+    auto append_integer = [&] (char tag, std::int64_t value) {
+      key += tag;
+      key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    if(column.m_type == RawColumn::Type::REAL) {
+      if(std::trunc(column.m_real) == column.m_real &&
+          std::abs(column.m_real) < 9.0e18) {
+        append_integer('I', static_cast<std::int64_t>(column.m_real));
+      } else {
+        key += 'R';
+        key.append(reinterpret_cast<const char*>(&column.m_real),
+          sizeof(column.m_real));
+      }
+    } else if(column.m_type == RawColumn::Type::INTEGER ||
+        column.m_type == RawColumn::Type::DATE_TIME) {
+      append_integer('I', column.m_integer);
+    } else {
+      append_integer(column.m_type == RawColumn::Type::TEXT ? 'T' : 'B',
+        static_cast<std::int64_t>(column.m_size));
+      key.append(column.m_data, column.m_size);
+    }
+    return true;
+  }
+
+  template<typename K>
+  bool append_key(const K& value, std::string& key, std::size_t& size) {
+    auto column = RawColumn();
+    auto buffer = std::string();
+    to_raw_column(value, column, buffer);
+    size += estimate_size(column);
+    return append_key(column, key);
+  }
+
+  template<typename K>
+  bool append_keys(const K& key, std::string& encoded_key,
+      std::size_t& size) {
+    if constexpr(is_tuple_v<K>) {
+      auto is_valid = true;
+      std::apply([&] (const auto&... elements) {
+        ((is_valid = append_key(elements, encoded_key, size) && is_valid),
+          ...);
+      }, key);
+      return is_valid;
+    } else {
+      return append_key(key, encoded_key, size);
+    }
+  }
+
+  template<typename K>
+  void append_row_value(const K& key, std::string& values) {
+    values += '(';
+    std::apply([&] (const auto&... elements) {
+      auto is_first = true;
+      ((values += (is_first ? "" : ", "), is_first = false,
+        to_sql(elements, values)), ...);
+    }, key);
+    values += ')';
+  }
+
+  template<typename R>
+  std::string get_row_value_name(const R& row,
+      const std::vector<int>& key_columns) {
+    auto name = std::string("(");
+    for(auto i : key_columns) {
+      if(name.size() != 1) {
+        name += ", ";
+      }
+      name += row.get_columns()[i].m_name;
+    }
+    name += ')';
+    return name;
+  }
+
+  template<typename R, typename K>
+  Expression make_key_comparison(const R& row,
+      const std::vector<int>& key_columns, const K& key) {
+    if constexpr(is_tuple_v<K>) {
+      if(std::tuple_size_v<K> != key_columns.size()) {
+        throw ExecuteException("Key does not match the primary key.");
+      }
+      auto values = std::string();
+      append_row_value(key, values);
+      return sym(get_row_value_name(row, key_columns)) ==
+        sym(std::move(values));
+    } else {
+      if(key_columns.size() != 1) {
+        throw ExecuteException("Key does not match the primary key.");
+      }
+      return sym(row.get_columns()[key_columns.front()].m_name) == key;
+    }
+  }
+
+  template<typename R, typename T>
+  bool get_key(const R& row, const std::vector<int>& key_columns,
+      const T& value, std::string& key) {
+    auto is_valid = true;
+    for(auto column : key_columns) {
+      auto raw_column = RawColumn();
+      auto buffer = std::string();
+      row.store_value(value, column, raw_column, buffer);
+      is_valid = append_key(raw_column, key) && is_valid;
+    }
+    return is_valid;
+  }
+
+  template<typename R>
+  std::vector<int> get_primary_key(const R& row) {
+    auto& indexes = row.get_indexes();
+    auto index = std::find_if(indexes.begin(), indexes.end(),
+      [] (const auto& index) {
+        return index.m_is_primary;
+      });
+    if(index == indexes.end()) {
+      throw ExecuteException("Row has no primary key.");
+    }
+    auto& columns = row.get_columns();
+    auto key = std::vector<int>();
+    for(auto& name : index->m_columns) {
+      auto column = std::find_if(columns.begin(), columns.end(),
+        [&] (const auto& column) {
+          return column.m_name == name;
+        });
+      if(column == columns.end()) {
+        throw ExecuteException("Primary key column not selected: " + name);
+      }
+      key.push_back(static_cast<int>(std::distance(columns.begin(), column)));
+    }
+    return key;
+  }
+}
+
+  //! The largest number of composite keys selected by a single query, since
+  //! each key adds a term to a chain of comparisons the database parses
+  //! recursively.
+  inline constexpr auto MAX_COMPOSITE_KEYS_PER_QUERY = std::size_t(500);
+
+  //! Selects the rows of a table matching a range of primary keys, issuing
+  //! one query per chunk of keys rather than one query per key.
+  /*!
+    \param connection The connection to select the rows on.
+    \param row The type of row to select, it must have a primary key.
+    \param table The name of the table to select from.
+    \param keys_begin An iterator to the first key, a key is a value for a
+           single column primary key, otherwise a std::tuple or std::pair
+           whose elements follow the primary key's columns.
+    \param keys_end An iterator to one past the last key.
+    \param out The destination written with a std::optional row for each
+           key, in key order, left empty where no row matches the key.
+    \param limits The limits each chunk of keys must fit within.
+  */
+  template<typename C, typename R, typename B, typename E, typename O>
+  void get_many(C& connection, const R& row, const std::string& table,
+      B keys_begin, E keys_end, O out, const BatchLimits& limits) {
+    using Type = typename R::Type;
+    using Key = std::decay_t<decltype(*keys_begin)>;
+    auto key_columns = Details::get_primary_key(row);
+    auto term = Expression();
+    if constexpr(Details::is_tuple_v<Key>) {
+      if(std::tuple_size_v<Key> != key_columns.size()) {
+        throw ExecuteException("Key does not match the primary key.");
+      }
+      term = sym(Details::get_row_value_name(row, key_columns));
+    } else {
+      if(key_columns.size() != 1) {
+        throw ExecuteException("Key does not match the primary key.");
+      }
+      term = sym(row.get_columns()[key_columns.front()].m_name);
+    }
+    auto chunk_limit = std::max<std::size_t>(1, std::min(limits.m_max_rows,
+      limits.m_max_parameters / key_columns.size()));
+    if constexpr(Details::is_tuple_v<Key>) {
+      chunk_limit = std::min(chunk_limit, MAX_COMPOSITE_KEYS_PER_QUERY);
+    }
+    auto keys = std::vector<Key>();
+    auto encoded_keys = std::vector<std::optional<std::string>>();
+    auto bytes = std::size_t(0);
+    auto rows = std::vector<Type>();
+    auto positions = std::unordered_map<std::string, std::size_t>();
+    auto flush = [&] {
+      auto where = Expression();
+      if constexpr(Details::is_tuple_v<Key>) {
+        for(auto& key : keys) {
+          auto values = std::string();
+          Details::append_row_value(key, values);
+          auto comparison = term == sym(std::move(values));
+          if(where.get_virtual_expression()) {
+            where = std::move(where) || std::move(comparison);
+          } else {
+            where = std::move(comparison);
+          }
+        }
+      } else {
+        where = in(term, keys);
+      }
+      rows.clear();
+      connection.execute(select(row, table, std::move(where),
+        std::back_inserter(rows)));
+      positions.clear();
+      for(auto i = std::size_t(0); i != rows.size(); ++i) {
+        auto key = std::string();
+        if(Details::get_key(row, key_columns, rows[i], key)) {
+          positions.emplace(std::move(key), i);
+        }
+      }
+      for(auto& key : encoded_keys) {
+        auto position = key ? positions.find(*key) : positions.end();
+        if(position == positions.end()) {
+          *out = std::optional<Type>();
+        } else {
+          *out = std::optional<Type>(rows[position->second]);
+        }
+        ++out;
+      }
+      keys.clear();
+      encoded_keys.clear();
+      bytes = 0;
+    };
+    for(auto i = keys_begin; i != keys_end; ++i) {
+      auto encoded_key = std::string();
+      auto size = std::size_t(0);
+      if(!Details::append_keys(*i, encoded_key, size)) {
+        if(keys.empty()) {
+          *out = std::optional<Type>();
+          ++out;
+        } else {
+          encoded_keys.emplace_back();
+        }
+        continue;
+      }
+      if(!keys.empty() && (keys.size() == chunk_limit ||
+          bytes >= limits.m_max_bytes || size > limits.m_max_bytes - bytes)) {
+        flush();
+      }
+      keys.push_back(*i);
+      encoded_keys.emplace_back(std::move(encoded_key));
+      bytes += size;
+    }
+    if(!keys.empty()) {
+      flush();
+    }
+  }
+}
+
+#endif
@@ -1,7 +1,10 @@
 #ifndef VIPER_INSERT_RANGE_STATEMENT_HPP
 #define VIPER_INSERT_RANGE_STATEMENT_HPP
+#include <ranges>
 #include <string>
+#include <type_traits>
 #include "Viper/Row.hpp"
+#include "Viper/Utilities.hpp"
 
 namespace Viper {
 
@@ -40,10 +43,10 @@ namespace Viper {
       const std::string& get_table() const;
 
       //! Returns the begin iterator.
-      Begin get_begin() const;
+      const Begin& get_begin() const;
 
       //! Returns the end iterator.
-      End get_end() const;
+      const End& get_end() const;
 
     private:
       Row m_row;
@@ -52,7 +55,8 @@ namespace Viper {
       End m_end;
   };
 
-  //! Builds an insert range statement.
+  //! Builds an insert range statement, an iterator that can not be copied
+  //! is shared by every copy of the statement.
   /*!
     \param row The type of row to insert.
     \param table The name of the table to insert into.
@@ -62,7 +66,8 @@ namespace Viper {
   template<typename R, typename B, typename E>
   auto insert(R row, std::string table, B begin, E end) {
     return InsertRangeStatement(std::move(row), std::move(table),
-      std::move(begin), std::move(end));
+      Details::share_iterator(std::move(begin)),
+      Details::share_iterator(std::move(end)));
   }
 
   //! Builds an insert statement for a single value.
@@ -77,6 +82,21 @@ namespace Viper {
       value + 1);
   }
 
+  //! Builds an insert statement for every value in a range, the range is
+  //! traversed only once so that values can be streamed from a generator.
+  /*!
+    \param row The type of row to insert.
+    \param table The name of the table to insert into.
+    \param range The range of values to insert, it must remain valid until the
+           statement is executed.
+  */
+  template<typename R, typename G,
+    typename = std::enable_if_t<std::ranges::input_range<G>>>
+  auto insert(R row, std::string table, G&& range) {
+    return insert(std::move(row), std::move(table), std::ranges::begin(range),
+      std::ranges::end(range));
+  }
+
   template<typename R, typename B, typename E>
   InsertRangeStatement<R, B, E>::InsertRangeStatement(Row row,
       std::string table, Begin begin, End end)
@@ -97,13 +117,13 @@ namespace Viper {
   }
 
   template<typename R, typename B, typename E>
-  typename InsertRangeStatement<R, B, E>::Begin
+  const typename InsertRangeStatement<R, B, E>::Begin&
       InsertRangeStatement<R, B, E>::get_begin() const {
     return m_begin;
   }
 
   template<typename R, typename B, typename E>
-  typename InsertRangeStatement<R, B, E>::End
+  const typename InsertRangeStatement<R, B, E>::End&
       InsertRangeStatement<R, B, E>::get_end() const {
     return m_end;
   }
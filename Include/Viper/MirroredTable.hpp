@@ -0,0 +1,482 @@
+#ifndef VIPER_MIRRORED_TABLE_HPP
+#define VIPER_MIRRORED_TABLE_HPP
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Viper/DeleteStatement.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/GetMany.hpp"
+#include "Viper/InsertRangeStatement.hpp"
+#include "Viper/Row.hpp"
+#include "Viper/SelectStatement.hpp"
+#include "Viper/UpsertStatement.hpp"
+
+namespace Viper {
+
+  /*! \brief Keeps a copy of a table's rows in memory, indexed by primary
+             key, so that lookups are answered without querying the
+             database.
+      \details The table is loaded once, after which the mirror is kept
+               current by the inserts, upserts and deletes made through it.
+               Writes made by any other means are only observed once the
+               table is loaded again.
+      \tparam T The type of value stored in the table.
+   */
+  template<typename T>
+  class MirroredTable {
+    public:
+
+      //! The type of value stored in the table.
+      using Type = T;
+
+      //! Constructs an empty mirror.
+      /*!
+        \param row The type of row stored in the table, it must have a
+               primary key.
+        \param table The name of the table to mirror.
+      */
+      MirroredTable(Row<Type> row, std::string table);
+
+      //! Returns the type of row stored in the table.
+      const Row<Type>& get_row() const;
+
+      //! Returns the name of the table mirrored.
+      const std::string& get_table() const;
+
+      //! Returns the number of rows mirrored.
+      std::size_t get_size() const;
+
+      //! Returns the rows mirrored, in no particular order.
+      const std::vector<Type>& get_values() const;
+
+      //! Replaces the mirrored rows with every row in the table.
+      /*!
+        \param connection The connection to select the rows on.
+      */
+      template<typename C>
+      void load(C& connection);
+
+      //! Inserts a range of values into the table and the mirror, a range
+      //! that can only be traversed once is first copied.
+      /*!
+        \param connection The connection to insert the values on.
+        \param begin An iterator to the first value to insert.
+        \param end An iterator to one past the last value to insert.
+      */
+      template<typename C, typename B, typename E>
+      void insert(C& connection, B begin, E end);
+
+      //! Upserts a range of values into the table and the mirror, a range
+      //! that can only be traversed once is first copied.
+      /*!
+        \param connection The connection to upsert the values on.
+        \param begin An iterator to the first value to upsert.
+        \param end An iterator to one past the last value to upsert.
+      */
+      template<typename C, typename B, typename E>
+      void upsert(C& connection, B begin, E end);
+
+      //! Deletes the row with a given primary key from the table and the
+      //! mirror.
+      /*!
+        \param connection The connection to delete the row on.
+        \param key The primary key of the row to delete, a std::tuple or
+               std::pair for a composite primary key.
+        \return <code>true</code> iff the row was mirrored.
+      */
+      template<typename C, typename K>
+      bool erase(C& connection, const K& key);
+
+      //! Returns the mirrored row with a given primary key.
+      /*!
+        \param key The primary key of the row, a std::tuple or std::pair for
+               a composite primary key.
+        \return The row, or <code>nullptr</code> if there is none, valid
+                until the mirror is next modified.
+      */
+      template<typename K>
+      const Type* find(const K& key) const;
+
+      //! Indexes a column so that find_all looks its values up by hash
+      //! instead of scanning every mirrored row.
+      /*!
+        \param column The name of the column to index.
+      */
+      void add_index(std::string_view column);
+
+      //! Writes every mirrored row whose column equals a value, a column
+      //! that is neither the primary key nor indexed is scanned linearly.
+      /*!
+        \param column The name of the column to compare.
+        \param value The value to compare the column with.
+        \param destination The destination written with each matching row.
+      */
+      template<typename V, typename D>
+      void find_all(std::string_view column, const V& value,
+        D destination) const;
+
+    private:
+      static constexpr auto EMPTY = std::numeric_limits<std::size_t>::max();
+      struct Slot {
+        std::size_t m_hash;
+        std::size_t m_index;
+      };
+      struct ColumnIndex {
+        int m_column;
+        std::unordered_multimap<std::string, std::size_t> m_positions;
+      };
+      Row<Type> m_row;
+      std::string m_table;
+      std::vector<int> m_key_columns;
+      std::vector<Type> m_values;
+      std::vector<std::string> m_keys;
+      std::vector<Slot> m_slots;
+      std::vector<ColumnIndex> m_indexes;
+
+      int get_column(std::string_view column) const;
+      bool encode(const Type& value, int column, std::string& key) const;
+      void add_to_indexes(const Type& value, std::size_t position);
+      void remove_from_indexes(const Type& value, std::size_t position);
+      template<typename B, typename E>
+      void store(B begin, E end);
+      void store(const Type& value);
+      void store(Type&& value);
+      std::size_t locate(std::string_view key, std::size_t hash) const;
+      void remove(std::size_t slot);
+      void rehash(std::size_t capacity);
+  };
+
+  template<typename T>
+  MirroredTable<T>::MirroredTable(Row<Type> row, std::string table)
+      : m_row(std::move(row)),
+        m_table(std::move(table)),
+        m_key_columns(Details::get_primary_key(m_row)) {}
+
+  template<typename T>
+  const Row<typename MirroredTable<T>::Type>&
+      MirroredTable<T>::get_row() const {
+    return m_row;
+  }
+
+  template<typename T>
+  const std::string& MirroredTable<T>::get_table() const {
+    return m_table;
+  }
+
+  template<typename T>
+  std::size_t MirroredTable<T>::get_size() const {
+    return m_values.size();
+  }
+
+  template<typename T>
+  const std::vector<typename MirroredTable<T>::Type>&
+      MirroredTable<T>::get_values() const {
+    return m_values;
+  }
+
+  template<typename T>
+  template<typename C>
+  void MirroredTable<T>::load(C& connection) {
+    auto values = std::vector<Type>();
+    connection.execute(select(m_row, m_table, std::back_inserter(values)));
+    m_values.clear();
+    m_keys.clear();
+    m_slots.clear();
+    for(auto& index : m_indexes) {
+      index.m_positions.clear();
+    }
+    rehash(values.size());
+    store(std::make_move_iterator(values.begin()),
+      std::make_move_iterator(values.end()));
+  }
+
+  template<typename T>
+  template<typename C, typename B, typename E>
+  void MirroredTable<T>::insert(C& connection, B begin, E end) {
+    if constexpr(std::forward_iterator<B>) {
+      connection.execute(Viper::insert(m_row, m_table, begin, end));
+      store(begin, end);
+    } else {
+      auto values = std::vector<Type>();
+      for(; begin != end; ++begin) {
+        values.push_back(*begin);
+      }
+      insert(connection, values.cbegin(), values.cend());
+    }
+  }
+
+  template<typename T>
+  template<typename C, typename B, typename E>
+  void MirroredTable<T>::upsert(C& connection, B begin, E end) {
+    if constexpr(std::forward_iterator<B>) {
+      connection.execute(Viper::upsert(m_row, m_table, begin, end));
+      store(begin, end);
+    } else {
+      auto values = std::vector<Type>();
+      for(; begin != end; ++begin) {
+        values.push_back(*begin);
+      }
+      upsert(connection, values.cbegin(), values.cend());
+    }
+  }
+
+  template<typename T>
+  template<typename C, typename K>
+  bool MirroredTable<T>::erase(C& connection, const K& key) {
+    connection.execute(Viper::erase(m_table,
+      Details::make_key_comparison(m_row, m_key_columns, key)));
+    auto encoded_key = std::string();
+    auto size = std::size_t(0);
+    if(m_slots.empty() || !Details::append_keys(key, encoded_key, size)) {
+      return false;
+    }
+    auto slot = locate(encoded_key, std::hash<std::string_view>()(
+      encoded_key));
+    if(m_slots[slot].m_index == EMPTY) {
+      return false;
+    }
+    remove(slot);
+    return true;
+  }
+
+  template<typename T>
+  template<typename K>
+  const typename MirroredTable<T>::Type*
+      MirroredTable<T>::find(const K& key) const {
+    auto encoded_key = std::string();
+    auto size = std::size_t(0);
+    if(m_slots.empty() || !Details::append_keys(key, encoded_key, size)) {
+      return nullptr;
+    }
+    auto index = m_slots[locate(encoded_key,
+      std::hash<std::string_view>()(encoded_key))].m_index;
+    if(index == EMPTY) {
+      return nullptr;
+    }
+    return &m_values[index];
+  }
+
+  template<typename T>
+  void MirroredTable<T>::add_index(std::string_view column) {
+    auto index = get_column(column);
+    if(std::any_of(m_indexes.begin(), m_indexes.end(),
+        [&] (const auto& candidate) {
+          return candidate.m_column == index;
+        })) {
+      return;
+    }
+    auto& column_index = m_indexes.emplace_back();
+    column_index.m_column = index;
+    auto key = std::string();
+    for(auto i = std::size_t(0); i != m_values.size(); ++i) {
+      key.clear();
+      if(encode(m_values[i], index, key)) {
+        column_index.m_positions.emplace(key, i);
+      }
+    }
+  }
+
+  template<typename T>
+  template<typename V, typename D>
+  void MirroredTable<T>::find_all(std::string_view column, const V& value,
+      D destination) const {
+    auto index = get_column(column);
+    if(m_key_columns.size() == 1 && m_key_columns.front() == index) {
+      if(auto match = find(value)) {
+        *destination = *match;
+        ++destination;
+      }
+      return;
+    }
+    auto encoded_value = std::string();
+    auto size = std::size_t(0);
+    if(!Details::append_key(value, encoded_value, size)) {
+      return;
+    }
+    auto column_index = std::find_if(m_indexes.begin(), m_indexes.end(),
+      [&] (const auto& candidate) {
+        return candidate.m_column == index;
+      });
+    if(column_index != m_indexes.end()) {
+      auto matches = column_index->m_positions.equal_range(encoded_value);
+      for(auto i = matches.first; i != matches.second; ++i) {
+        *destination = m_values[i->second];
+        ++destination;
+      }
+      return;
+    }
+    auto raw_column = RawColumn();
+    auto buffer = std::string();
+    auto encoded_column = std::string();
+    for(auto& candidate : m_values) {
+      m_row.store_value(candidate, index, raw_column, buffer);
+      encoded_column.clear();
+      if(Details::append_key(raw_column, encoded_column) &&
+          encoded_column == encoded_value) {
+        *destination = candidate;
+        ++destination;
+      }
+    }
+  }
+
+  template<typename T>
+  int MirroredTable<T>::get_column(std::string_view column) const {
+    auto& columns = m_row.get_columns();
+    auto position = std::find_if(columns.begin(), columns.end(),
+      [&] (const auto& c) {
+        return c.m_name == column;
+      });
+    if(position == columns.end()) {
+      throw ExecuteException("Column not found: " + std::string(column));
+    }
+    return static_cast<int>(std::distance(columns.begin(), position));
+  }
+
+  template<typename T>
+  bool MirroredTable<T>::encode(const Type& value, int column,
+      std::string& key) const {
+    auto raw_column = RawColumn();
+    auto buffer = std::string();
+    m_row.store_value(value, column, raw_column, buffer);
+    return Details::append_key(raw_column, key);
+  }
+
+  template<typename T>
+  void MirroredTable<T>::add_to_indexes(const Type& value,
+      std::size_t position) {
+    auto key = std::string();
+    for(auto& index : m_indexes) {
+      key.clear();
+      if(encode(value, index.m_column, key)) {
+        index.m_positions.emplace(key, position);
+      }
+    }
+  }
+
+  template<typename T>
+  void MirroredTable<T>::remove_from_indexes(const Type& value,
+      std::size_t position) {
+    auto key = std::string();
+    for(auto& index : m_indexes) {
+      key.clear();
+      if(!encode(value, index.m_column, key)) {
+        continue;
+      }
+      auto matches = index.m_positions.equal_range(key);
+      for(auto i = matches.first; i != matches.second; ++i) {
+        if(i->second == position) {
+          index.m_positions.erase(i);
+          break;
+        }
+      }
+    }
+  }
+
+  template<typename T>
+  template<typename B, typename E>
+  void MirroredTable<T>::store(B begin, E end) {
+    for(auto i = begin; i != end; ++i) {
+      store(*i);
+    }
+  }
+
+  template<typename T>
+  void MirroredTable<T>::store(const Type& value) {
+    store(Type(value));
+  }
+
+  template<typename T>
+  void MirroredTable<T>::store(Type&& value) {
+    auto key = std::string();
+    if(!Details::get_key(m_row, m_key_columns, value, key)) {
+      return;
+    }
+    if(2 * (m_values.size() + 1) > m_slots.size()) {
+      rehash(m_values.size() + 1);
+    }
+    auto hash = std::hash<std::string_view>()(key);
+    auto& slot = m_slots[locate(key, hash)];
+    if(slot.m_index != EMPTY) {
+      remove_from_indexes(m_values[slot.m_index], slot.m_index);
+      m_values[slot.m_index] = std::move(value);
+      add_to_indexes(m_values[slot.m_index], slot.m_index);
+      return;
+    }
+    slot = Slot{hash, m_values.size()};
+    m_values.push_back(std::move(value));
+    m_keys.push_back(std::move(key));
+    add_to_indexes(m_values.back(), m_values.size() - 1);
+  }
+
+  template<typename T>
+  std::size_t MirroredTable<T>::locate(std::string_view key,
+      std::size_t hash) const {
+    auto mask = m_slots.size() - 1;
+    auto slot = hash & mask;
+    while(m_slots[slot].m_index != EMPTY && (m_slots[slot].m_hash != hash ||
+        m_keys[m_slots[slot].m_index] != key)) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  template<typename T>
+  void MirroredTable<T>::remove(std::size_t slot) {
+    auto index = m_slots[slot].m_index;
+    auto last = m_values.size() - 1;
+    remove_from_indexes(m_values[index], index);
+    if(index != last) {
+      remove_from_indexes(m_values[last], last);
+      add_to_indexes(m_values[last], index);
+      auto& moved = m_slots[locate(m_keys[last],
+        std::hash<std::string_view>()(m_keys[last]))];
+      moved.m_index = index;
+      m_values[index] = std::move(m_values[last]);
+      m_keys[index] = std::move(m_keys[last]);
+    }
+    m_values.pop_back();
+    m_keys.pop_back();
+    auto mask = m_slots.size() - 1;
+    auto hole = slot;
+    auto next = (hole + 1) & mask;
+    while(m_slots[next].m_index != EMPTY) {
+      auto home = m_slots[next].m_hash & mask;
+      if(((next - home) & mask) >= ((next - hole) & mask)) {
+        m_slots[hole] = m_slots[next];
+        hole = next;
+      }
+      next = (next + 1) & mask;
+    }
+    m_slots[hole].m_index = EMPTY;
+  }
+
+  template<typename T>
+  void MirroredTable<T>::rehash(std::size_t capacity) {
+    auto size = std::size_t(16);
+    while(size < 2 * capacity) {
+      size *= 2;
+    }
+    if(size <= m_slots.size()) {
+      return;
+    }
+    m_slots.assign(size, Slot{0, EMPTY});
+    auto mask = size - 1;
+    for(auto i = std::size_t(0); i != m_keys.size(); ++i) {
+      auto hash = std::hash<std::string_view>()(m_keys[i]);
+      auto slot = hash & mask;
+      while(m_slots[slot].m_index != EMPTY) {
+        slot = (slot + 1) & mask;
+      }
+      m_slots[slot] = Slot{hash, i};
+    }
+  }
+}
+
+#endif
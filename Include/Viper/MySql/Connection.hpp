@@ -1,19 +1,31 @@
 #ifndef VIPER_MYSQL_CONNECTION_HPP
 #define VIPER_MYSQL_CONNECTION_HPP
+#include <algorithm>
+#include <exception>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <vector>
 #include <mysql.h>
+#include "Viper/BatchLimits.hpp"
 #include "Viper/CommitStatement.hpp"
 #include "Viper/ConnectException.hpp"
 #include "Viper/CreateTableStatement.hpp"
+#include "Viper/Cursor.hpp"
 #include "Viper/DeleteStatement.hpp"
 #include "Viper/ExecuteException.hpp"
+#include "Viper/GetMany.hpp"
 #include "Viper/InsertRangeStatement.hpp"
 #include "Viper/RollbackStatement.hpp"
 #include "Viper/SelectStatement.hpp"
 #include "Viper/UpdateStatement.hpp"
 #include "Viper/MySql/DataTypeName.hpp"
+#include "Viper/MySql/Fetch.hpp"
+#include "Viper/MySql/LocalInfile.hpp"
+#include "Viper/MySql/PreparedStatement.hpp"
 #include "Viper/MySql/QueryBuilder.hpp"
+#include "Viper/MySql/Statement.hpp"
+#include "Viper/MySql/TemporaryKeySets.hpp"
 #include "Viper/StartTransactionStatement.hpp"
 
 namespace Viper::MySql {
@@ -71,6 +83,20 @@ namespace Viper::MySql {
       template<typename T, typename B, typename E>
       void execute(const InsertRangeStatement<T, B, E>& statement);
 
+      //! Loads a range of rows into a table by streaming them to the server
+      //! as a LOAD DATA LOCAL INFILE, falling back to batched inserts if the
+      //! server does not accept local files.
+      /*!
+        \param row The type of row to load.
+        \param table The name of the table to load the rows into.
+        \param begin An input iterator to the beginning of the range to load.
+        \param end An input iterator to the end of the range to load.
+        \return <code>true</code> iff the rows were streamed to the server,
+                <code>false</code> iff they were inserted in batches.
+      */
+      template<typename R, typename B, typename E>
+      bool bulk_load(R row, std::string table, B begin, E end);
+
       //! Executes an update statement.
       /*!
         \param statement The statement to execute.
@@ -91,6 +117,43 @@ namespace Viper::MySql {
       template<typename T, typename D>
       void execute(const SelectStatement<T, D>& statement);
 
+      //! Appends the SQL a select statement is executed with, rendering its
+      //! IN lists as literals rather than staging them.
+      /*!
+        \param statement The statement to render.
+        \param query The string to append the SQL to.
+      */
+      template<typename T, typename D>
+      void append_query(const SelectStatement<T, D>& statement,
+        std::string& query) const;
+
+      //! Executes a select whose rows are streamed from the server as they
+      //! are iterated over, rather than being buffered client side.
+      /*!
+        \param row The type of row to select.
+        \param from The table to select from.
+        \param clauses The clauses, such as a where or limit, to select with.
+        \return A cursor over the selected rows, no other query can run on
+                this connection until the cursor is exhausted or destroyed.
+      */
+      template<typename R, typename... C>
+      Cursor<R, Statement> query(R row, FromClause from, C&&... clauses);
+
+      //! Selects the rows matching a range of primary keys, issuing one query
+      //! per chunk of keys that fits within the batch limits.
+      /*!
+        \param row The type of row to select, it must have a primary key.
+        \param table The name of the table to select from.
+        \param keys_begin An iterator to the first key, a std::tuple or
+               std::pair for a composite primary key.
+        \param keys_end An iterator to one past the last key.
+        \param out The destination written with a std::optional row for each
+               key, in key order, left empty where no row matches the key.
+      */
+      template<typename R, typename B, typename E, typename O>
+      void get_many(const R& row, const std::string& table, B keys_begin,
+        E keys_end, O out);
+
       //! Starts a transaction.
       /*!
         \param statement The statement to execute.
@@ -109,12 +172,72 @@ namespace Viper::MySql {
       */
       void execute(const RollbackStatement& statement);
 
+      //! Compiles a select statement so that it can be executed repeatedly.
+      /*!
+        \param statement The statement to compile, its parameters are bound
+               when the prepared select is executed.
+        \return The prepared select, which must not be executed once this
+                connection is closed.
+      */
+      template<typename T, typename D>
+      PreparedSelect<T, D> prepare(const SelectStatement<T, D>& statement);
+
+      //! Compiles a delete statement so that it can be executed repeatedly.
+      /*!
+        \param statement The statement to compile, its parameters are bound
+               when the prepared statement is executed.
+        \return The prepared statement, which must not be executed once this
+                connection is closed.
+      */
+      PreparedStatement prepare(const DeleteStatement& statement);
+
+      //! Compiles an update statement so that it can be executed repeatedly.
+      /*!
+        \param statement The statement to compile, its parameters are bound
+               when the prepared statement is executed.
+        \return The prepared statement, which must not be executed once this
+                connection is closed.
+      */
+      PreparedStatement prepare(const UpdateStatement& statement);
+
+      //! Returns the limits insert and upsert batches must fit within.
+      const BatchLimits& get_batch_limits() const;
+
+      //! Sets the limits insert and upsert batches must fit within, once
+      //! opened they are further bounded by the server's own limits.
+      /*!
+        \param limits The limits to write batches within.
+      */
+      void set_batch_limits(const BatchLimits& limits);
+
+      //! Returns the batches written by inserts and upserts.
+      const BatchStatistics& get_batch_statistics() const;
+
+      //! Returns the smallest number of keys in an IN expression that are
+      //! staged in a temporary table rather than rendered as literals.
+      std::size_t get_key_set_threshold() const;
+
+      //! Sets the smallest number of keys in an IN expression that are staged
+      //! in a temporary table rather than rendered as literals.
+      /*!
+        \param threshold The smallest number of keys to stage.
+      */
+      void set_key_set_threshold(std::size_t threshold);
+
       //! Opens a connection to the MySQL database.
       void open();
 
       //! Closes the connection to the MySQL database.
       void close();
 
+      //! Tests if the connection to the server is alive.
+      bool ping();
+
+      //! Resets the session's state, such as its variables, temporary tables
+      //! and open transaction, so that the connection can be handed to
+      //! another user, invalidating any prepared statements.
+      void reset();
+
     private:
       static inline std::mutex m_init_mutex;
       std::string m_host;
@@ -123,9 +246,18 @@ namespace Viper::MySql {
       std::string m_password;
       std::string m_database;
       ::MYSQL* m_handle;
+      BatchLimits m_batch_limits;
+      BatchStatistics m_batch_statistics;
+      WriteBuffer m_write_buffer;
+      TemporaryKeySets m_key_sets;
 
       Connection(const Connection&) = delete;
       Connection& operator =(const Connection&) = delete;
+      template<typename S>
+      void write(const S& statement);
+      template<typename S>
+      KeySetLease stage_query(const S& statement, std::string& query);
+      void clamp_batch_limits();
   };
 
   inline Connection::Connection(std::string host, unsigned int port,
@@ -143,7 +275,11 @@ namespace Viper::MySql {
         m_username(std::move(connection.m_username)),
         m_password(std::move(connection.m_password)),
         m_database(std::move(connection.m_database)),
-        m_handle(connection.m_handle) {
+        m_handle(connection.m_handle),
+        m_batch_limits(connection.m_batch_limits),
+        m_batch_statistics(connection.m_batch_statistics),
+        m_write_buffer(std::move(connection.m_write_buffer)),
+        m_key_sets(std::move(connection.m_key_sets)) {
     connection.m_handle = nullptr;
   }
 
@@ -201,90 +337,99 @@ namespace Viper::MySql {
 
   inline void Connection::execute(const DeleteStatement& statement) {
     auto query = std::string();
-    build_query(statement, query);
+    auto key_sets = stage_query(statement, query);
     execute(query);
   }
 
   template<typename T, typename B, typename E>
   void Connection::execute(const InsertRangeStatement<T, B, E>& statement) {
-    constexpr auto MAX_WRITES = std::size_t(300);
-    auto count = std::distance(statement.get_begin(), statement.get_end());
-    execute("START TRANSACTION;");
-    auto i = statement.get_begin();
-    while(count != 0) {
-      auto sub_count = std::min<std::size_t>(MAX_WRITES, count);
-      auto e = i;
-      std::advance(e, sub_count);
-      auto sub_range = insert(statement.get_row(), statement.get_table(), i, e);
-      auto query = std::string();
-      build_query(sub_range, query);
-      execute(query);
-      std::advance(i, sub_count);
-      count -= sub_count;
+    write(statement);
+  }
+
+  template<typename R, typename B, typename E>
+  bool Connection::bulk_load(R row, std::string table, B begin, E end) {
+    constexpr auto NOT_ALLOWED_COMMAND = 1148u;
+    constexpr auto LOCAL_INFILE_REJECTED = 2068u;
+    constexpr auto LOCAL_FILES_DISABLED = 3948u;
+    if(begin == end || row.get_columns().empty()) {
+      return true;
     }
-    execute("COMMIT;");
+    auto query = std::string();
+    build_bulk_load_query(row, table, query);
+    auto file = LocalInfile<R, B, E>(row, begin, end);
+    file.install(m_handle);
+    auto result = ::mysql_real_query(m_handle, query.c_str(),
+      static_cast<unsigned long>(query.size()));
+    deny_local_infile(m_handle);
+    if(result == 0) {
+      return true;
+    }
+    if(auto error = file.get_error()) {
+      std::rethrow_exception(error);
+    }
+    auto code = ::mysql_errno(m_handle);
+    if(file.is_started() || (code != NOT_ALLOWED_COMMAND &&
+        code != LOCAL_INFILE_REJECTED && code != LOCAL_FILES_DISABLED)) {
+      throw ExecuteException(::mysql_error(m_handle));
+    }
+    execute(insert(std::move(row), std::move(table), std::move(begin),
+      std::move(end)));
+    return false;
   }
 
   inline void Connection::execute(const UpdateStatement& statement) {
     auto query = std::string();
-    build_query(statement, query);
+    auto key_sets = stage_query(statement, query);
     execute(query);
   }
 
   template<typename T, typename B, typename E>
   void Connection::execute(const UpsertStatement<T, B, E>& statement) {
-    constexpr auto MAX_WRITES = std::size_t(300);
-    auto count = std::distance(statement.get_begin(), statement.get_end());
-    execute("START TRANSACTION;");
-    auto i = statement.get_begin();
-    while(count != 0) {
-      auto sub_count = std::min<std::size_t>(MAX_WRITES, count);
-      auto e = i;
-      std::advance(e, sub_count);
-      auto sub_range = upsert(statement.get_row(), statement.get_table(), i, e);
-      auto query = std::string();
-      build_query(sub_range, query);
-      execute(query);
-      std::advance(i, sub_count);
-      count -= sub_count;
-    }
-    execute("COMMIT;");
+    write(statement);
   }
 
   template<typename T, typename D>
   void Connection::execute(const SelectStatement<T, D>& statement) {
     auto query = std::string();
-    build_query(statement, query);
+    auto key_sets = stage_query(statement, query);
     if(query.empty()) {
       return;
     }
-    auto result = ::mysql_query(m_handle, query.c_str());
-    if(result != 0) {
-      throw ExecuteException(::mysql_error(m_handle));
-    }
-    auto rows = ::mysql_store_result(m_handle);
-    if(rows == nullptr) {
-      throw ExecuteException(::mysql_error(m_handle));
-    }
-    auto count = ::mysql_num_fields(rows);
-    auto destination = statement.get_first();
-    std::vector<RawColumn> columns;
-    columns.reserve(statement.get_row().get_columns().size());
-    while(auto row = ::mysql_fetch_row(rows)) {
-      columns.clear();
-      auto lengths = ::mysql_fetch_lengths(rows);
-      for(auto i = 0;
-          i != static_cast<int>(statement.get_row().get_columns().size());
-          ++i) {
-        columns.push_back(RawColumn{
-          row[i], static_cast<std::size_t>(lengths[i])});
-      }
-      auto value = typename SelectStatement<T, D>::Row::Type();
-      statement.get_row().extract(columns.data(), value);
-      *destination = std::move(value);
-      ++destination;
+    auto prepared_statement = Statement(m_handle, query, std::move(key_sets));
+    prepared_statement.bind_result(statement.get_row().get_columns());
+    prepared_statement.execute(nullptr);
+    fetch(prepared_statement, statement.get_row(), statement.get_first());
+  }
+
+  template<typename T, typename D>
+  void Connection::append_query(const SelectStatement<T, D>& statement,
+      std::string& query) const {
+    build_query(statement, query);
+  }
+
+  template<typename R, typename... C>
+  Cursor<R, Statement> Connection::query(R row, FromClause from,
+      C&&... clauses) {
+    auto columns = std::vector<std::string>();
+    for(auto& column : row.get_columns()) {
+      columns.push_back(column.m_name);
     }
-    ::mysql_free_result(rows);
+    auto select_statement = select(std::move(columns), std::move(from),
+      std::forward<C>(clauses)...);
+    auto query = std::string();
+    auto key_sets = stage_query(select_statement, query);
+    query += ';';
+    auto statement = Statement(m_handle, query, std::move(key_sets));
+    statement.bind_result(row.get_columns());
+    statement.stream(nullptr);
+    return Cursor<R, Statement>(std::move(row), std::move(statement));
+  }
+
+  template<typename R, typename B, typename E, typename O>
+  void Connection::get_many(const R& row, const std::string& table,
+      B keys_begin, E keys_end, O out) {
+    Viper::get_many(*this, row, table, std::move(keys_begin),
+      std::move(keys_end), std::move(out), m_batch_limits);
   }
 
   inline void Connection::execute(const StartTransactionStatement& statement) {
@@ -305,6 +450,52 @@ namespace Viper::MySql {
     execute(query);
   }
 
+  template<typename T, typename D>
+  PreparedSelect<T, D> Connection::prepare(
+      const SelectStatement<T, D>& statement) {
+    auto query = std::string();
+    auto key_sets = stage_query(statement, query);
+    return PreparedSelect<T, D>(Statement(m_handle, query,
+      std::move(key_sets)), statement.get_row(), statement.get_first());
+  }
+
+  inline PreparedStatement Connection::prepare(
+      const DeleteStatement& statement) {
+    auto query = std::string();
+    auto key_sets = stage_query(statement, query);
+    return PreparedStatement(Statement(m_handle, query, std::move(key_sets)));
+  }
+
+  inline PreparedStatement Connection::prepare(
+      const UpdateStatement& statement) {
+    auto query = std::string();
+    auto key_sets = stage_query(statement, query);
+    return PreparedStatement(Statement(m_handle, query, std::move(key_sets)));
+  }
+
+  inline const BatchLimits& Connection::get_batch_limits() const {
+    return m_batch_limits;
+  }
+
+  inline void Connection::set_batch_limits(const BatchLimits& limits) {
+    m_batch_limits = limits;
+    if(m_handle != nullptr) {
+      clamp_batch_limits();
+    }
+  }
+
+  inline const BatchStatistics& Connection::get_batch_statistics() const {
+    return m_batch_statistics;
+  }
+
+  inline std::size_t Connection::get_key_set_threshold() const {
+    return m_key_sets.get_threshold();
+  }
+
+  inline void Connection::set_key_set_threshold(std::size_t threshold) {
+    m_key_sets.set_threshold(threshold);
+  }
+
   inline void Connection::open() {
     if(m_handle != nullptr) {
       return;
@@ -320,15 +511,19 @@ namespace Viper::MySql {
     ::mysql_options(m_handle, MYSQL_OPT_RECONNECT, &reconnect);
     ::my_bool verify = 0;
     ::mysql_options(m_handle, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, &verify);
+    auto local_infile = 1u;
+    ::mysql_options(m_handle, MYSQL_OPT_LOCAL_INFILE, &local_infile);
     auto result = ::mysql_real_connect(m_handle, m_host.c_str(),
       m_username.c_str(), m_password.c_str(), m_database.c_str(), m_port,
-      nullptr, CLIENT_MULTI_STATEMENTS);
+      nullptr, CLIENT_MULTI_STATEMENTS | CLIENT_LOCAL_FILES);
     if(result == nullptr) {
       auto error = std::string(::mysql_error(m_handle));
       ::mysql_close(m_handle);
       m_handle = nullptr;
       throw ConnectException(error);
     }
+    deny_local_infile(m_handle);
+    clamp_batch_limits();
   }
 
   inline void Connection::close() {
@@ -337,6 +532,84 @@ namespace Viper::MySql {
     }
     ::mysql_close(m_handle);
     m_handle = nullptr;
+    m_key_sets.clear();
+  }
+
+  inline bool Connection::ping() {
+    return m_handle != nullptr && ::mysql_ping(m_handle) == 0;
+  }
+
+  inline void Connection::reset() {
+    m_key_sets.clear();
+    if(::mysql_reset_connection(m_handle) != 0) {
+      throw ExecuteException(::mysql_error(m_handle));
+    }
+  }
+
+  template<typename S>
+  void Connection::write(const S& statement) {
+    auto prepared_statement = std::optional<Statement>();
+    auto prepared_count = std::size_t(0);
+    execute("START TRANSACTION;");
+    try {
+      write_batches(statement, m_batch_limits, m_write_buffer,
+        m_batch_statistics,
+        [&] (std::size_t count, const RawColumn* parameters) {
+          if(count != prepared_count) {
+            auto& query = m_write_buffer.m_query;
+            query.clear();
+            build_prepared_query(statement, count, query);
+            prepared_statement.reset();
+            prepared_statement.emplace(m_handle, query);
+            prepared_count = count;
+          }
+          prepared_statement->execute(parameters);
+        });
+    } catch(...) {
+      execute("ROLLBACK;");
+      throw;
+    }
+    execute("COMMIT;");
+  }
+
+  template<typename S>
+  KeySetLease Connection::stage_query(const S& statement, std::string& query) {
+    auto scope = KeySetScope(m_key_sets.get_threshold());
+    build_query(statement, query);
+    if(scope.get_key_sets().empty()) {
+      return nullptr;
+    }
+    auto subqueries = std::vector<std::string>();
+    auto key_sets = m_key_sets.stage(m_handle, scope.get_key_sets(),
+      subqueries);
+    if(!key_sets) {
+      return nullptr;
+    }
+    scope.set_subqueries(std::move(subqueries));
+    query.clear();
+    build_query(statement, query);
+    return key_sets;
+  }
+
+  inline void Connection::clamp_batch_limits() {
+    constexpr auto MAX_PARAMETERS = std::size_t(65535);
+    constexpr auto PACKET_OVERHEAD = std::size_t(1024);
+    m_batch_limits.m_max_parameters =
+      std::min(m_batch_limits.m_max_parameters, MAX_PARAMETERS);
+    if(::mysql_query(m_handle, "SELECT @@max_allowed_packet;") != 0) {
+      return;
+    }
+    auto result = ::mysql_store_result(m_handle);
+    if(result == nullptr) {
+      return;
+    }
+    auto row = ::mysql_fetch_row(result);
+    if(row != nullptr && row[0] != nullptr) {
+      auto max_packet = static_cast<std::size_t>(std::stoull(row[0]));
+      m_batch_limits.m_max_bytes = std::min(m_batch_limits.m_max_bytes,
+        max_packet - std::min(max_packet, PACKET_OVERHEAD));
+    }
+    ::mysql_free_result(result);
   }
 }
 
@@ -0,0 +1,27 @@
+#ifndef VIPER_MYSQL_FETCH_HPP
+#define VIPER_MYSQL_FETCH_HPP
+#include <utility>
+#include "Viper/MySql/Statement.hpp"
+
+namespace Viper::MySql {
+
+  //! Fetches the rows of an executed statement, extracting each one into a
+  //! destination.
+  /*!
+    \param statement The statement to fetch from, its results must be bound
+           to the row's columns.
+    \param row The type of row to extract.
+    \param destination An output iterator used to store the rows.
+  */
+  template<typename R, typename D>
+  void fetch(Statement& statement, const R& row, D destination) {
+    while(statement.fetch()) {
+      auto value = typename R::Type();
+      row.extract(statement.get_columns(), value);
+      *destination = std::move(value);
+      ++destination;
+    }
+  }
+}
+
+#endif
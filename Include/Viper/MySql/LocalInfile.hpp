@@ -0,0 +1,239 @@
+#ifndef VIPER_MYSQL_LOCAL_INFILE_HPP
+#define VIPER_MYSQL_LOCAL_INFILE_HPP
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <utility>
+#include <mysql.h>
+#include "Viper/Conversions.hpp"
+#include "Viper/DataTypes/DateTimeDataType.hpp"
+
+namespace Viper::MySql {
+namespace Details {
+  constexpr auto LOCAL_INFILE_ERROR = 2000;
+
+  inline int write_local_infile_error(const char* message, char* buffer,
+      unsigned int size) {
+    if(size != 0) {
+      auto length = std::min<std::size_t>(std::strlen(message), size - 1);
+      std::memcpy(buffer, message, length);
+      buffer[length] = '\0';
+    }
+    return LOCAL_INFILE_ERROR;
+  }
+
+  inline int deny_local_infile_init(void** pointer, const char* path,
+      void* data) {
+    *pointer = nullptr;
+    return 1;
+  }
+
+  inline int deny_local_infile_read(void* pointer, char* buffer,
+      unsigned int size) {
+    return -1;
+  }
+
+  inline void deny_local_infile_end(void* pointer) {}
+
+  inline int deny_local_infile_error(void* pointer, char* buffer,
+      unsigned int size) {
+    return write_local_infile_error(
+      "Local files can only be read by a bulk load.", buffer, size);
+  }
+}
+
+  //! Appends a raw column to a tab separated stream read by LOAD DATA,
+  //! escaping it with backslashes and representing NULL as \N.
+  /*!
+    \param column The column to append.
+    \param stream The stream to append the column to.
+  */
+  inline void append_tab_separated(const RawColumn& column,
+      std::string& stream) {
+    if(is_null(column)) {
+      stream += "\\N";
+      return;
+    }
+    if(column.m_type == RawColumn::Type::INTEGER) {
+      char value[24];
+      auto last = std::to_chars(value, value + sizeof(value),
+        column.m_integer).ptr;
+      stream.append(value, last);
+    } else if(column.m_type == RawColumn::Type::REAL) {
+      char value[32];
+      auto last = std::to_chars(value, value + sizeof(value),
+        column.m_real).ptr;
+      stream.append(value, last);
+    } else if(column.m_type == RawColumn::Type::DATE_TIME) {
+      char value[DATE_TIME_CHARS];
+      auto last = to_chars(value,
+        DateTime(static_cast<std::uint64_t>(column.m_integer)));
+      stream.append(value, last);
+    } else {
+      for(auto i = column.m_data; i != column.m_data + column.m_size; ++i) {
+        if(*i == '\\') {
+          stream += "\\\\";
+        } else if(*i == '\t') {
+          stream += "\\t";
+        } else if(*i == '\n') {
+          stream += "\\n";
+        } else if(*i == '\r') {
+          stream += "\\r";
+        } else if(*i == '\0') {
+          stream += "\\0";
+        } else {
+          stream += *i;
+        }
+      }
+    }
+  }
+
+  /*! \brief Serializes a range of rows on demand as the tab separated file
+             requested by a LOAD DATA LOCAL INFILE statement.
+      \tparam R The type of row to serialize.
+      \tparam B The type of input iterator to the beginning of the range.
+      \tparam E The type of input iterator to the end of the range.
+   */
+  template<typename R, typename B, typename E>
+  class LocalInfile {
+    public:
+
+      //! The type of row to serialize.
+      using Row = R;
+
+      //! Constructs a local infile.
+      /*!
+        \param row The type of row to serialize.
+        \param begin An input iterator to the beginning of the range.
+        \param end An input iterator to the end of the range.
+      */
+      LocalInfile(const Row& row, B begin, E end);
+
+      //! Returns <code>true</code> iff the server has read from this file.
+      bool is_started() const;
+
+      //! Returns the exception thrown while serializing a row, if any.
+      std::exception_ptr get_error() const;
+
+      //! Installs this file as the one read by the next LOAD DATA LOCAL
+      //! INFILE statement.
+      /*!
+        \param handle The connection to read from this file.
+      */
+      void install(::MYSQL* handle);
+
+    private:
+      const Row* m_row;
+      B m_current;
+      E m_end;
+      RawColumn m_column;
+      std::string m_buffer;
+      std::string m_stream;
+      std::size_t m_offset;
+      bool m_is_started;
+      std::exception_ptr m_error;
+
+      static int init(void** pointer, const char* path, void* data);
+      static int read(void* pointer, char* buffer, unsigned int size);
+      static void end(void* pointer);
+      static int error(void* pointer, char* buffer, unsigned int size);
+      void append_row();
+  };
+
+  //! Rejects every LOAD DATA LOCAL INFILE statement outside of a bulk load,
+  //! so that a server can not request arbitrary local files.
+  /*!
+    \param handle The connection to protect.
+  */
+  inline void deny_local_infile(::MYSQL* handle) {
+    ::mysql_set_local_infile_handler(handle, &Details::deny_local_infile_init,
+      &Details::deny_local_infile_read, &Details::deny_local_infile_end,
+      &Details::deny_local_infile_error, nullptr);
+  }
+
+  template<typename R, typename B, typename E>
+  LocalInfile<R, B, E>::LocalInfile(const Row& row, B begin, E end)
+      : m_row(&row),
+        m_current(std::move(begin)),
+        m_end(std::move(end)),
+        m_column(),
+        m_offset(0),
+        m_is_started(false) {}
+
+  template<typename R, typename B, typename E>
+  bool LocalInfile<R, B, E>::is_started() const {
+    return m_is_started;
+  }
+
+  template<typename R, typename B, typename E>
+  std::exception_ptr LocalInfile<R, B, E>::get_error() const {
+    return m_error;
+  }
+
+  template<typename R, typename B, typename E>
+  void LocalInfile<R, B, E>::install(::MYSQL* handle) {
+    ::mysql_set_local_infile_handler(handle, &LocalInfile::init,
+      &LocalInfile::read, &LocalInfile::end, &LocalInfile::error, this);
+  }
+
+  template<typename R, typename B, typename E>
+  int LocalInfile<R, B, E>::init(void** pointer, const char* path,
+      void* data) {
+    *pointer = data;
+    return 0;
+  }
+
+  template<typename R, typename B, typename E>
+  int LocalInfile<R, B, E>::read(void* pointer, char* buffer,
+      unsigned int size) {
+    auto& file = *static_cast<LocalInfile*>(pointer);
+    file.m_is_started = true;
+    try {
+      file.m_stream.erase(0, file.m_offset);
+      file.m_offset = 0;
+      while(file.m_stream.size() - file.m_offset < size &&
+          file.m_current != file.m_end) {
+        file.append_row();
+        ++file.m_current;
+      }
+    } catch(...) {
+      file.m_error = std::current_exception();
+      return -1;
+    }
+    auto count = std::min<std::size_t>(size,
+      file.m_stream.size() - file.m_offset);
+    std::memcpy(buffer, file.m_stream.data() + file.m_offset, count);
+    file.m_offset += count;
+    return static_cast<int>(count);
+  }
+
+  template<typename R, typename B, typename E>
+  void LocalInfile<R, B, E>::end(void* pointer) {}
+
+  template<typename R, typename B, typename E>
+  int LocalInfile<R, B, E>::error(void* pointer, char* buffer,
+      unsigned int size) {
+    return Details::write_local_infile_error("Unable to serialize row.",
+      buffer, size);
+  }
+
+  template<typename R, typename B, typename E>
+  void LocalInfile<R, B, E>::append_row() {
+    auto count = static_cast<int>(m_row->get_columns().size());
+    auto&& value = *m_current;
+    for(auto i = 0; i != count; ++i) {
+      if(i != 0) {
+        m_stream += '\t';
+      }
+      m_row->store_value(value, i, m_column, m_buffer);
+      append_tab_separated(m_column, m_stream);
+    }
+    m_stream += '\n';
+  }
+}
+
+#endif
@@ -3,6 +3,11 @@
 #include "Viper/Viper.hpp"
 #include "Viper/MySql/Connection.hpp"
 #include "Viper/MySql/DataTypeName.hpp"
+#include "Viper/MySql/Fetch.hpp"
+#include "Viper/MySql/LocalInfile.hpp"
+#include "Viper/MySql/PreparedStatement.hpp"
 #include "Viper/MySql/QueryBuilder.hpp"
+#include "Viper/MySql/Statement.hpp"
+#include "Viper/MySql/TemporaryKeySets.hpp"
 
 #endif
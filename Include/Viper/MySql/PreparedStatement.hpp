@@ -0,0 +1,132 @@
+#ifndef VIPER_MYSQL_PREPARED_STATEMENT_HPP
+#define VIPER_MYSQL_PREPARED_STATEMENT_HPP
+#include <array>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include "Viper/Conversions.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/MySql/Fetch.hpp"
+#include "Viper/MySql/Statement.hpp"
+
+namespace Viper::MySql {
+namespace Details {
+  template<typename... A>
+  void execute_arguments(Statement& statement,
+      std::array<std::string, sizeof...(A)>& buffers, const A&... arguments) {
+    if(sizeof...(A) != statement.get_parameter_count()) {
+      throw ExecuteException("Parameter count mismatch.");
+    }
+    auto columns = std::array<RawColumn, sizeof...(A)>();
+    if constexpr(sizeof...(A) != 0) {
+      auto index = std::size_t(0);
+      ((to_raw_column(arguments, columns[index], buffers[index]), ++index),
+        ...);
+    }
+    statement.execute(columns.data());
+  }
+}
+
+  //! Keeps a statement compiled so that it can be executed repeatedly with
+  //! new values bound to its parameters.
+  class PreparedStatement {
+    public:
+
+      //! Constructs a prepared statement.
+      /*!
+        \param statement The compiled statement.
+      */
+      explicit PreparedStatement(Statement statement);
+
+      //! Returns the number of parameters the statement expects.
+      std::size_t get_parameter_count() const;
+
+      //! Binds values to the parameters in order of appearance and executes
+      //! the statement.
+      /*!
+        \param arguments The values to bind, one per parameter.
+      */
+      template<typename... A>
+      void execute(const A&... arguments);
+
+    private:
+      Statement m_statement;
+  };
+
+  /*! \brief Keeps a select statement compiled so that it can be executed
+             repeatedly with new values bound to its parameters.
+      \tparam R The type of row to select.
+      \tparam D The output iterator to store the rows in.
+   */
+  template<typename R, typename D>
+  class PreparedSelect {
+    public:
+
+      //! The type of row to select.
+      using Row = R;
+
+      //! The output iterator to store the rows in.
+      using Destination = D;
+
+      //! Constructs a prepared select.
+      /*!
+        \param statement The compiled statement.
+        \param row The type of row to select.
+        \param first An output iterator used to store the rows.
+      */
+      PreparedSelect(Statement statement, Row row, Destination first);
+
+      //! Returns the number of parameters the statement expects.
+      std::size_t get_parameter_count() const;
+
+      //! Binds values to the parameters in order of appearance and stores the
+      //! selected rows in the destination.
+      /*!
+        \param arguments The values to bind, one per parameter.
+      */
+      template<typename... A>
+      void execute(const A&... arguments);
+
+    private:
+      Statement m_statement;
+      Row m_row;
+      Destination m_first;
+  };
+
+  inline PreparedStatement::PreparedStatement(Statement statement)
+      : m_statement(std::move(statement)) {}
+
+  inline std::size_t PreparedStatement::get_parameter_count() const {
+    return m_statement.get_parameter_count();
+  }
+
+  template<typename... A>
+  void PreparedStatement::execute(const A&... arguments) {
+    auto buffers = std::array<std::string, sizeof...(A)>();
+    Details::execute_arguments(m_statement, buffers, arguments...);
+  }
+
+  template<typename R, typename D>
+  PreparedSelect<R, D>::PreparedSelect(Statement statement, Row row,
+      Destination first)
+      : m_statement(std::move(statement)),
+        m_row(std::move(row)),
+        m_first(std::move(first)) {
+    m_statement.bind_result(m_row.get_columns());
+  }
+
+  template<typename R, typename D>
+  std::size_t PreparedSelect<R, D>::get_parameter_count() const {
+    return m_statement.get_parameter_count();
+  }
+
+  template<typename R, typename D>
+  template<typename... A>
+  void PreparedSelect<R, D>::execute(const A&... arguments) {
+    auto buffers = std::array<std::string, sizeof...(A)>();
+    Details::execute_arguments(m_statement, buffers, arguments...);
+    fetch(m_statement, m_row, m_first);
+  }
+}
+
+#endif
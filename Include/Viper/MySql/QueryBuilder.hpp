@@ -40,6 +40,62 @@ namespace Details {
         query += item;
       });
   }
+
+  template<typename R>
+  void append_parameters(const R& row, const std::string& table,
+      std::size_t count, std::string& query) {
+    constexpr auto FIXED_SIZE = std::size_t(64);
+    auto& columns = row.get_columns();
+    auto size = FIXED_SIZE + table.size() + count * (2 * columns.size() + 2);
+    for(auto& column : columns) {
+      size += 3 * column.m_name.size() + 16;
+    }
+    query.reserve(query.size() + size);
+    query += "INSERT INTO ";
+    query += table;
+    query += " (";
+    append_list(columns, query,
+      [] (const auto& column, auto& query) {
+        query += column.m_name;
+      });
+    query += ") VALUES ";
+    for(auto i = std::size_t(0); i != count; ++i) {
+      if(i != 0) {
+        query += ',';
+      }
+      query += '(';
+      for(auto j = std::size_t(0); j != columns.size(); ++j) {
+        if(j != 0) {
+          query += ',';
+        }
+        query += '?';
+      }
+      query += ')';
+    }
+  }
+
+  template<typename R>
+  void append_conflict_clause(const R& row, std::string& query) {
+    query += " ON DUPLICATE KEY UPDATE ";
+    auto indicies = std::vector<std::string>();
+    for(auto& index : row.get_indexes()) {
+      if(index.m_is_unique) {
+        indicies.insert(indicies.end(), index.m_columns.begin(),
+          index.m_columns.end());
+      }
+    }
+    append_list(row.get_columns(), query,
+      [&] (const auto& column, auto& query) {
+        auto is_unique = std::find(indicies.begin(), indicies.end(),
+          column.m_name) != indicies.end();
+        if(!is_unique) {
+          query += column.m_name;
+          query += " = VALUES(";
+          query += column.m_name;
+          query += ")";
+        }
+      });
+  }
 }
 
   //! Builds a create table query statement.
@@ -54,10 +110,13 @@ namespace Details {
     if(statement.get_exists_flag()) {
       query += "IF NOT EXISTS ";
     }
-    query += statement.get_name() + '(';
+    query += statement.get_name();
+    query += '(';
     Details::append_list(statement.get_row().get_columns(), query,
       [] (const auto& column, auto& query) {
-        query += column.m_name + ' ' + get_name(*column.m_type);
+        query += column.m_name;
+        query += ' ';
+        query += get_name(*column.m_type);
         if(!column.m_is_nullable) {
           query += " NOT NULL";
         }
@@ -68,11 +127,15 @@ namespace Details {
         Details::append_list(index.m_columns, query);
         query += ')';
       } else if(index.m_is_unique) {
-        query += ",UNIQUE KEY " + index.m_name + "(";
+        query += ",UNIQUE KEY ";
+        query += index.m_name;
+        query += '(';
         Details::append_list(index.m_columns, query);
         query += ')';
       } else {
-        query += ",KEY " + index.m_name + "(";
+        query += ",KEY ";
+        query += index.m_name;
+        query += '(';
         Details::append_list(index.m_columns, query);
         query += ')';
       }
@@ -89,10 +152,13 @@ namespace Details {
   inline void build_query(const DeleteStatement& statement,
       std::string& query) {
     if(statement.get_where().has_value()) {
-      query += "DELETE FROM " + statement.get_table() + " WHERE ";
+      query += "DELETE FROM ";
+      query += statement.get_table();
+      query += " WHERE ";
       statement.get_where()->append_query(query);
     } else {
-      query += "TRUNCATE TABLE " + statement.get_table();
+      query += "TRUNCATE TABLE ";
+      query += statement.get_table();
     }
     query += ';';
   }
@@ -134,6 +200,43 @@ namespace Details {
     query += ';';
   }
 
+  //! Builds an insert query whose values are bound as parameters.
+  /*!
+    \param statement The statement whose row and table are inserted into.
+    \param count The number of rows of parameters to insert.
+    \param query The string to store the query in.
+  */
+  template<typename T, typename B, typename E>
+  void build_prepared_query(const InsertRangeStatement<T, B, E>& statement,
+      std::size_t count, std::string& query) {
+    if(count == 0 || statement.get_row().get_columns().empty()) {
+      return;
+    }
+    Details::append_parameters(statement.get_row(), statement.get_table(),
+      count, query);
+    query += ';';
+  }
+
+  //! Builds a query loading a tab separated local file into a table.
+  /*!
+    \param row The type of row stored in the file.
+    \param table The name of the table to load the file into.
+    \param query The string to store the query in.
+  */
+  template<typename R>
+  void build_bulk_load_query(const R& row, const std::string& table,
+      std::string& query) {
+    query += "LOAD DATA LOCAL INFILE 'viper' INTO TABLE ";
+    query += table;
+    query += " CHARACTER SET binary FIELDS TERMINATED BY '\\t' "
+      "ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' (";
+    Details::append_list(row.get_columns(), query,
+      [] (const auto& column, auto& query) {
+        query += column.m_name;
+      });
+    query += ");";
+  }
+
   //! Builds an update statement.
   /*!
     \param statement The statement to build.
@@ -188,25 +291,25 @@ namespace Details {
         }
         query += ')';
       });
-    query += " ON DUPLICATE KEY UPDATE ";
-    auto indicies = std::vector<std::string>();
-    for(auto& index : statement.get_row().get_indexes()) {
-      if(index.m_is_unique) {
-        indicies.insert(indicies.end(), index.m_columns.begin(),
-          index.m_columns.end());
-      }
+    Details::append_conflict_clause(statement.get_row(), query);
+    query += ';';
+  }
+
+  //! Builds an upsert query whose values are bound as parameters.
+  /*!
+    \param statement The statement whose row and table are upserted into.
+    \param count The number of rows of parameters to upsert.
+    \param query The string to store the query in.
+  */
+  template<typename T, typename B, typename E>
+  void build_prepared_query(const UpsertStatement<T, B, E>& statement,
+      std::size_t count, std::string& query) {
+    if(count == 0 || statement.get_row().get_columns().empty()) {
+      return;
     }
-    Details::append_list(statement.get_row().get_columns(), query,
-      [&] (const auto& column, auto& query) {
-        auto is_unique = std::find(indicies.begin(), indicies.end(),
-          column.m_name) != indicies.end();
-        if(!is_unique) {
-          query += column.m_name;
-          query += " = VALUES(";
-          query += column.m_name;
-          query += ")";
-        }
-      });
+    Details::append_parameters(statement.get_row(), statement.get_table(),
+      count, query);
+    Details::append_conflict_clause(statement.get_row(), query);
     query += ';';
   }
 
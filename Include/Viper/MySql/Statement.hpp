@@ -0,0 +1,345 @@
+#ifndef VIPER_MYSQL_STATEMENT_HPP
+#define VIPER_MYSQL_STATEMENT_HPP
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mysql.h>
+#include "Viper/Column.hpp"
+#include "Viper/Conversions.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/DataTypes/DataTypes.hpp"
+#include "Viper/Expressions/InExpression.hpp"
+
+namespace Viper::MySql {
+
+  //! Executes a query through MySQL's binary protocol, binding parameters
+  //! and results directly to their native representations.
+  class Statement {
+    public:
+
+      //! Prepares a statement.
+      /*!
+        \param handle The connection to prepare the statement on.
+        \param query The query to prepare.
+        \param key_sets The lease on the key sets the query reads.
+      */
+      Statement(::MYSQL* handle, const std::string& query,
+        KeySetLease key_sets = nullptr);
+
+      //! Moves a statement.
+      Statement(Statement&& statement);
+
+      ~Statement();
+
+      //! Returns the number of parameters the statement expects.
+      std::size_t get_parameter_count() const;
+
+      //! Binds parameters and executes the statement, if results are bound
+      //! then they are buffered client side to be fetched.
+      /*!
+        \param parameters The values to bind, one per parameter.
+      */
+      void execute(const RawColumn* parameters);
+
+      //! Binds parameters and executes the statement, leaving its results on
+      //! the server to be fetched one row at a time. No other query can run
+      //! on the connection until every row is fetched or this statement is
+      //! destroyed.
+      /*!
+        \param parameters The values to bind, one per parameter.
+      */
+      void stream(const RawColumn* parameters);
+
+      //! Binds the statement's results to the native types of a row's columns,
+      //! the binding is kept across executions.
+      /*!
+        \param columns The columns of the row being selected.
+      */
+      void bind_result(const std::vector<Column>& columns);
+
+      //! Fetches the next row.
+      /*!
+        \return <code>true</code> iff a row was fetched.
+      */
+      bool fetch();
+
+      //! Returns the columns of the most recently fetched row.
+      const RawColumn* get_columns() const;
+
+    private:
+      enum class Kind {
+        INTEGER,
+        REAL,
+        DATE_TIME,
+        BLOB,
+        TEXT
+      };
+      struct Result {
+        Kind m_kind;
+        bool m_is_unsigned;
+        std::int64_t m_integer;
+        double m_real;
+        ::MYSQL_TIME m_time;
+        std::vector<char> m_buffer;
+        unsigned long m_length;
+        ::my_bool m_is_null;
+        ::my_bool m_error;
+      };
+      ::MYSQL_STMT* m_statement;
+      KeySetLease m_key_sets;
+      std::vector<::MYSQL_BIND> m_parameters;
+      std::vector<::MYSQL_TIME> m_times;
+      std::vector<::MYSQL_BIND> m_binds;
+      std::vector<Result> m_results;
+      std::vector<RawColumn> m_columns;
+
+      Statement(const Statement&) = delete;
+      Statement& operator =(const Statement&) = delete;
+      void execute(const RawColumn* parameters, bool is_buffered);
+      void fetch_truncated();
+  };
+
+  //! Converts a DateTime to its MySQL representation.
+  inline ::MYSQL_TIME to_mysql_time(DateTime value) {
+    auto tm = to_tm(value);
+    auto time = ::MYSQL_TIME();
+    time.year = tm.tm_year + 1900;
+    time.month = tm.tm_mon + 1;
+    time.day = tm.tm_mday;
+    time.hour = tm.tm_hour;
+    time.minute = tm.tm_min;
+    time.second = tm.tm_sec;
+    time.second_part = static_cast<unsigned long>(
+      (value.get_ticks() % DateTime::TICKS_PER_SECOND) *
+      (1000000 / DateTime::TICKS_PER_SECOND));
+    time.time_type = MYSQL_TIMESTAMP_DATETIME;
+    return time;
+  }
+
+  //! Converts a MySQL date/time to a DateTime.
+  inline DateTime from_mysql_time(const ::MYSQL_TIME& time) {
+    return DateTime(time.year, time.month, time.day, time.hour, time.minute,
+      time.second, static_cast<int>(time.second_part /
+      (1000000 / DateTime::TICKS_PER_SECOND)));
+  }
+
+  inline Statement::Statement(::MYSQL* handle, const std::string& query,
+      KeySetLease key_sets)
+      : m_statement(::mysql_stmt_init(handle)),
+        m_key_sets(std::move(key_sets)) {
+    if(m_statement == nullptr) {
+      throw ExecuteException(::mysql_error(handle));
+    }
+    if(::mysql_stmt_prepare(m_statement, query.c_str(),
+        static_cast<unsigned long>(query.size())) != 0) {
+      auto error = std::string(::mysql_stmt_error(m_statement));
+      ::mysql_stmt_close(m_statement);
+      throw ExecuteException(error);
+    }
+    m_parameters.resize(::mysql_stmt_param_count(m_statement));
+    m_times.resize(m_parameters.size());
+  }
+
+  inline Statement::Statement(Statement&& statement)
+      : m_statement(statement.m_statement),
+        m_key_sets(std::move(statement.m_key_sets)),
+        m_parameters(std::move(statement.m_parameters)),
+        m_times(std::move(statement.m_times)),
+        m_binds(std::move(statement.m_binds)),
+        m_results(std::move(statement.m_results)),
+        m_columns(std::move(statement.m_columns)) {
+    statement.m_statement = nullptr;
+  }
+
+  inline Statement::~Statement() {
+    if(m_statement == nullptr) {
+      return;
+    }
+    ::mysql_stmt_close(m_statement);
+  }
+
+  inline std::size_t Statement::get_parameter_count() const {
+    return m_parameters.size();
+  }
+
+  inline void Statement::execute(const RawColumn* parameters) {
+    execute(parameters, true);
+  }
+
+  inline void Statement::stream(const RawColumn* parameters) {
+    execute(parameters, false);
+  }
+
+  inline void Statement::execute(const RawColumn* parameters,
+      bool is_buffered) {
+    if(!m_binds.empty()) {
+      ::mysql_stmt_free_result(m_statement);
+    }
+    for(auto i = std::size_t(0); i != m_parameters.size(); ++i) {
+      auto& parameter = parameters[i];
+      auto& bind = m_parameters[i];
+      bind = ::MYSQL_BIND();
+      if(is_null(parameter)) {
+        bind.buffer_type = MYSQL_TYPE_NULL;
+      } else if(parameter.m_type == RawColumn::Type::INTEGER) {
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = const_cast<std::int64_t*>(&parameter.m_integer);
+      } else if(parameter.m_type == RawColumn::Type::REAL) {
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = const_cast<double*>(&parameter.m_real);
+      } else if(parameter.m_type == RawColumn::Type::DATE_TIME) {
+        m_times[i] = to_mysql_time(
+          DateTime(static_cast<std::uint64_t>(parameter.m_integer)));
+        bind.buffer_type = MYSQL_TYPE_DATETIME;
+        bind.buffer = &m_times[i];
+      } else {
+        if(parameter.m_type == RawColumn::Type::BLOB) {
+          bind.buffer_type = MYSQL_TYPE_BLOB;
+        } else {
+          bind.buffer_type = MYSQL_TYPE_STRING;
+        }
+        bind.buffer = const_cast<char*>(parameter.m_data);
+        bind.buffer_length = static_cast<unsigned long>(parameter.m_size);
+      }
+    }
+    if((!m_parameters.empty() &&
+        ::mysql_stmt_bind_param(m_statement, m_parameters.data()) != 0) ||
+        ::mysql_stmt_execute(m_statement) != 0 || (is_buffered &&
+        !m_binds.empty() && ::mysql_stmt_store_result(m_statement) != 0)) {
+      throw ExecuteException(::mysql_stmt_error(m_statement));
+    }
+  }
+
+  inline void Statement::bind_result(const std::vector<Column>& columns) {
+    struct KindVisitor final : DataTypeVisitor {
+      Result* m_result;
+
+      void visit(const BlobDataType& type) override {
+        m_result->m_kind = Kind::BLOB;
+      }
+
+      void visit(const DataType& type) override {
+        m_result->m_kind = Kind::TEXT;
+      }
+
+      void visit(const DateTimeDataType& type) override {
+        m_result->m_kind = Kind::DATE_TIME;
+      }
+
+      void visit(const FloatDataType& type) override {
+        m_result->m_kind = Kind::REAL;
+      }
+
+      void visit(const IntegerDataType& type) override {
+        m_result->m_kind = Kind::INTEGER;
+        m_result->m_is_unsigned = !type.is_signed();
+      }
+    };
+    static constexpr auto INITIAL_BUFFER_SIZE = std::size_t(256);
+    m_results.assign(columns.size(), Result());
+    m_binds.assign(columns.size(), ::MYSQL_BIND());
+    m_columns.assign(columns.size(), RawColumn());
+    for(auto i = std::size_t(0); i != columns.size(); ++i) {
+      auto& result = m_results[i];
+      auto& bind = m_binds[i];
+      auto visitor = KindVisitor();
+      visitor.m_result = &result;
+      columns[i].m_type->apply(visitor);
+      bind.is_null = &result.m_is_null;
+      bind.length = &result.m_length;
+      bind.error = &result.m_error;
+      if(result.m_kind == Kind::INTEGER) {
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &result.m_integer;
+        bind.is_unsigned = result.m_is_unsigned;
+      } else if(result.m_kind == Kind::REAL) {
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &result.m_real;
+      } else if(result.m_kind == Kind::DATE_TIME) {
+        bind.buffer_type = MYSQL_TYPE_DATETIME;
+        bind.buffer = &result.m_time;
+      } else {
+        if(result.m_kind == Kind::BLOB) {
+          bind.buffer_type = MYSQL_TYPE_BLOB;
+        } else {
+          bind.buffer_type = MYSQL_TYPE_STRING;
+        }
+        result.m_buffer.resize(INITIAL_BUFFER_SIZE);
+        bind.buffer = result.m_buffer.data();
+        bind.buffer_length = static_cast<unsigned long>(result.m_buffer.size());
+      }
+    }
+    if(::mysql_stmt_bind_result(m_statement, m_binds.data()) != 0) {
+      throw ExecuteException(::mysql_stmt_error(m_statement));
+    }
+  }
+
+  inline bool Statement::fetch() {
+    auto status = ::mysql_stmt_fetch(m_statement);
+    if(status == MYSQL_NO_DATA) {
+      return false;
+    } else if(status == MYSQL_DATA_TRUNCATED) {
+      fetch_truncated();
+    } else if(status != 0) {
+      throw ExecuteException(::mysql_stmt_error(m_statement));
+    }
+    for(auto i = std::size_t(0); i != m_results.size(); ++i) {
+      auto& result = m_results[i];
+      auto& column = m_columns[i];
+      if(result.m_is_null) {
+        column.m_type = RawColumn::Type::NONE;
+        column.m_data = nullptr;
+        column.m_size = 0;
+      } else if(result.m_kind == Kind::INTEGER) {
+        column.m_type = RawColumn::Type::INTEGER;
+        column.m_integer = result.m_integer;
+      } else if(result.m_kind == Kind::REAL) {
+        column.m_type = RawColumn::Type::REAL;
+        column.m_real = result.m_real;
+      } else if(result.m_kind == Kind::DATE_TIME) {
+        column.m_type = RawColumn::Type::DATE_TIME;
+        column.m_integer = static_cast<std::int64_t>(
+          from_mysql_time(result.m_time).get_ticks());
+      } else {
+        if(result.m_kind == Kind::BLOB) {
+          column.m_type = RawColumn::Type::BLOB;
+        } else {
+          column.m_type = RawColumn::Type::TEXT;
+        }
+        column.m_data = result.m_buffer.data();
+        column.m_size = result.m_length;
+      }
+    }
+    return true;
+  }
+
+  inline const RawColumn* Statement::get_columns() const {
+    return m_columns.data();
+  }
+
+  inline void Statement::fetch_truncated() {
+    auto is_rebound = false;
+    for(auto i = std::size_t(0); i != m_results.size(); ++i) {
+      auto& result = m_results[i];
+      if((result.m_kind != Kind::TEXT && result.m_kind != Kind::BLOB) ||
+          !result.m_error || result.m_length <= result.m_buffer.size()) {
+        continue;
+      }
+      auto& bind = m_binds[i];
+      result.m_buffer.resize(result.m_length);
+      bind.buffer = result.m_buffer.data();
+      bind.buffer_length = static_cast<unsigned long>(result.m_buffer.size());
+      if(::mysql_stmt_fetch_column(m_statement, &bind,
+          static_cast<unsigned int>(i), 0) != 0) {
+        throw ExecuteException(::mysql_stmt_error(m_statement));
+      }
+      is_rebound = true;
+    }
+    if(is_rebound &&
+        ::mysql_stmt_bind_result(m_statement, m_binds.data()) != 0) {
+      throw ExecuteException(::mysql_stmt_error(m_statement));
+    }
+  }
+}
+
+#endif
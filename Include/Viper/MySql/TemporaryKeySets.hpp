@@ -0,0 +1,189 @@
+#ifndef VIPER_MYSQL_TEMPORARY_KEY_SETS_HPP
+#define VIPER_MYSQL_TEMPORARY_KEY_SETS_HPP
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <mysql.h>
+#include "Viper/ExecuteException.hpp"
+#include "Viper/Expressions/InExpression.hpp"
+#include "Viper/MySql/Statement.hpp"
+
+namespace Viper::MySql {
+
+  //! Stages the keys of large IN lists in session temporary tables, so that
+  //! they are bound as parameters instead of being parsed as SQL literals.
+  class TemporaryKeySets {
+    public:
+
+      //! The smallest number of keys staged by default.
+      static constexpr auto DEFAULT_THRESHOLD = std::size_t(256);
+
+      //! The number of keys inserted by each statement filling a table.
+      static constexpr auto CHUNK_SIZE = std::size_t(1000);
+
+      //! Constructs an empty set of tables.
+      TemporaryKeySets();
+
+      //! Moves a set of tables, leaving the source empty.
+      TemporaryKeySets(TemporaryKeySets&& key_sets);
+
+      //! Returns the smallest number of keys that are staged.
+      std::size_t get_threshold() const;
+
+      //! Sets the smallest number of keys that are staged.
+      /*!
+        \param threshold The smallest number of keys to stage.
+      */
+      void set_threshold(std::size_t threshold);
+
+      //! Stages key sets in tables that no other query has reserved.
+      /*!
+        \param handle The connection the query is executed on.
+        \param key_sets The key sets to stage.
+        \param subqueries Stores a subquery selecting each staged key set.
+        \return A lease reserving the tables until it is released, or
+                <code>nullptr</code> iff the keys could not be staged.
+      */
+      KeySetLease stage(::MYSQL* handle,
+        const std::vector<const std::vector<RawColumn>*>& key_sets,
+        std::vector<std::string>& subqueries);
+
+      //! Forgets the tables created so far, such as after the session's
+      //! temporary tables were dropped.
+      void clear();
+
+    private:
+      struct Tables {
+        std::vector<bool> m_reservations;
+        std::vector<std::string> m_types;
+      };
+      std::size_t m_threshold;
+      std::shared_ptr<Tables> m_tables;
+
+      TemporaryKeySets(const TemporaryKeySets&) = delete;
+      TemporaryKeySets& operator =(const TemporaryKeySets&) = delete;
+      static void execute(::MYSQL* handle, const std::string& query);
+      static void fill(::MYSQL* handle, const std::string& table,
+        const std::vector<RawColumn>& keys);
+  };
+
+  //! Returns the name of the MySQL type storing a key.
+  inline std::string get_key_type_name(const RawColumn& key) {
+    if(key.m_type == RawColumn::Type::INTEGER) {
+      return "BIGINT";
+    } else if(key.m_type == RawColumn::Type::REAL) {
+      return "DOUBLE";
+    } else if(key.m_type == RawColumn::Type::DATE_TIME) {
+      return "DATETIME(6)";
+    } else if(key.m_type == RawColumn::Type::BLOB) {
+      return "BLOB";
+    }
+    return "TEXT";
+  }
+
+  inline TemporaryKeySets::TemporaryKeySets()
+      : m_threshold(DEFAULT_THRESHOLD),
+        m_tables(std::make_shared<Tables>()) {}
+
+  inline TemporaryKeySets::TemporaryKeySets(TemporaryKeySets&& key_sets)
+      : m_threshold(key_sets.m_threshold),
+        m_tables(std::exchange(key_sets.m_tables,
+          std::make_shared<Tables>())) {}
+
+  inline std::size_t TemporaryKeySets::get_threshold() const {
+    return m_threshold;
+  }
+
+  inline void TemporaryKeySets::set_threshold(std::size_t threshold) {
+    m_threshold = threshold;
+  }
+
+  inline KeySetLease TemporaryKeySets::stage(::MYSQL* handle,
+      const std::vector<const std::vector<RawColumn>*>& key_sets,
+      std::vector<std::string>& subqueries) {
+    subqueries.clear();
+    if(handle == nullptr) {
+      return nullptr;
+    }
+    auto tables = m_tables;
+    auto lease = std::shared_ptr<std::vector<std::size_t>>(
+      new std::vector<std::size_t>(),
+      [=] (std::vector<std::size_t>* indexes) {
+        for(auto index : *indexes) {
+          tables->m_reservations[index] = false;
+        }
+        delete indexes;
+      });
+    auto& reservations = tables->m_reservations;
+    auto& types = tables->m_types;
+    try {
+      for(auto keys : key_sets) {
+        auto index = std::size_t(0);
+        while(index != reservations.size() && reservations[index]) {
+          ++index;
+        }
+        auto table = "viper_keys_" + std::to_string(index);
+        auto type = get_key_type_name(keys->front());
+        if(index == reservations.size()) {
+          reservations.push_back(false);
+          types.emplace_back();
+        }
+        if(types[index] != type) {
+          types[index].clear();
+          execute(handle, "DROP TEMPORARY TABLE IF EXISTS " + table);
+          execute(handle,
+            "CREATE TEMPORARY TABLE " + table + " (value " + type + ")");
+          types[index] = type;
+        }
+        fill(handle, table, *keys);
+        reservations[index] = true;
+        lease->push_back(index);
+        subqueries.push_back("SELECT value FROM " + table);
+      }
+    } catch(const ExecuteException&) {
+      subqueries.clear();
+      return nullptr;
+    }
+    return lease;
+  }
+
+  inline void TemporaryKeySets::clear() {
+    m_tables = std::make_shared<Tables>();
+  }
+
+  inline void TemporaryKeySets::execute(::MYSQL* handle,
+      const std::string& query) {
+    if(::mysql_real_query(handle, query.c_str(),
+        static_cast<unsigned long>(query.size())) != 0) {
+      throw ExecuteException(::mysql_error(handle));
+    }
+  }
+
+  inline void TemporaryKeySets::fill(::MYSQL* handle, const std::string& table,
+      const std::vector<RawColumn>& keys) {
+    execute(handle, "DELETE FROM " + table);
+    auto insert = [&] (std::size_t size) {
+      auto query = "INSERT INTO " + table + " VALUES (?)";
+      for(auto i = std::size_t(1); i != size; ++i) {
+        query += ",(?)";
+      }
+      return Statement(handle, query);
+    };
+    auto chunk = insert(std::min(CHUNK_SIZE, keys.size()));
+    auto offset = std::size_t(0);
+    while(keys.size() - offset >= CHUNK_SIZE) {
+      chunk.execute(keys.data() + offset);
+      offset += CHUNK_SIZE;
+    }
+    if(offset == 0) {
+      chunk.execute(keys.data());
+    } else if(offset != keys.size()) {
+      insert(keys.size() - offset).execute(keys.data() + offset);
+    }
+  }
+}
+
+#endif
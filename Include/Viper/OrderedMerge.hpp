@@ -0,0 +1,154 @@
+#ifndef VIPER_ORDERED_MERGE_HPP
+#define VIPER_ORDERED_MERGE_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Viper/Conversions.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/SelectClause.hpp"
+
+namespace Viper {
+namespace Details {
+  inline int get_collation_rank(RawColumn::Type type) {
+    if(type == RawColumn::Type::NONE) {
+      return 0;
+    } else if(type == RawColumn::Type::TEXT) {
+      return 2;
+    } else if(type == RawColumn::Type::BLOB) {
+      return 3;
+    }
+    return 1;
+  }
+
+  inline int compare(const RawColumn& left, const RawColumn& right) {
+    auto left_rank = get_collation_rank(left.m_type);
+    auto right_rank = get_collation_rank(right.m_type);
+    if(left_rank != right_rank) {
+      return left_rank < right_rank ? -1 : 1;
+    } else if(left_rank == 0) {
+      return 0;
+    } else if(left_rank == 1) {
+      if(left.m_type != RawColumn::Type::REAL &&
+          right.m_type != RawColumn::Type::REAL) {
+        return (left.m_integer > right.m_integer) -
+          (left.m_integer < right.m_integer);
+      }
+      auto left_value = left.m_type == RawColumn::Type::REAL ? left.m_real :
+        static_cast<double>(left.m_integer);
+      auto right_value = right.m_type == RawColumn::Type::REAL ?
+        right.m_real : static_cast<double>(right.m_integer);
+      return (left_value > right_value) - (left_value < right_value);
+    }
+    auto size = std::min(left.m_size, right.m_size);
+    if(size != 0) {
+      if(auto result = std::memcmp(left.m_data, right.m_data, size)) {
+        return result < 0 ? -1 : 1;
+      }
+    }
+    return (left.m_size > right.m_size) - (left.m_size < right.m_size);
+  }
+}
+
+  //! Merges result sets that are each sorted according to a select clause's
+  //! order by, stopping once the clause's limit is reached. Without an order
+  //! by the result sets are concatenated.
+  /*!
+    \param row The type of row selected, it must include every column ordered
+           by.
+    \param clause The select clause producing each result set.
+    \param partials The result sets to merge, whose values are moved from.
+    \param destination An output iterator used to store the merged rows.
+  */
+  template<typename R, typename D>
+  void merge_ordered(const R& row, const SelectClause& clause,
+      std::vector<std::vector<typename R::Type>>& partials, D destination) {
+    struct Head {
+      std::size_t m_position;
+      std::vector<RawColumn> m_keys;
+      std::vector<std::string> m_buffers;
+    };
+    auto limit = std::numeric_limits<std::size_t>::max();
+    if(clause.get_limit() && clause.get_limit()->m_value >= 0) {
+      limit = static_cast<std::size_t>(clause.get_limit()->m_value);
+    }
+    auto count = std::size_t(0);
+    if(!clause.get_order()) {
+      for(auto& partial : partials) {
+        for(auto& value : partial) {
+          if(count == limit) {
+            return;
+          }
+          *destination = std::move(value);
+          ++destination;
+          ++count;
+        }
+      }
+      return;
+    }
+    auto& columns = row.get_columns();
+    auto key_columns = std::vector<int>();
+    auto directions = std::vector<int>();
+    for(auto& order : clause.get_order()->m_columns) {
+      auto column = std::find_if(columns.begin(), columns.end(),
+        [&] (const auto& column) {
+          return column.m_name == order.m_name;
+        });
+      if(column == columns.end()) {
+        throw ExecuteException(
+          "Shards can only be merged on selected columns.");
+      }
+      key_columns.push_back(static_cast<int>(column - columns.begin()));
+      directions.push_back(order.m_order);
+    }
+    auto heads = std::vector<Head>(partials.size());
+    auto load = [&] (std::size_t shard) {
+      auto& head = heads[shard];
+      auto& value = partials[shard][head.m_position];
+      for(auto i = std::size_t(0); i != key_columns.size(); ++i) {
+        row.store_value(value, key_columns[i], head.m_keys[i],
+          head.m_buffers[i]);
+      }
+    };
+    auto is_after = [&] (std::size_t left, std::size_t right) {
+      for(auto i = std::size_t(0); i != key_columns.size(); ++i) {
+        auto result = Details::compare(heads[left].m_keys[i],
+          heads[right].m_keys[i]);
+        if(result != 0) {
+          return directions[i] == Order::ASC ? result > 0 : result < 0;
+        }
+      }
+      return left > right;
+    };
+    auto heap = std::vector<std::size_t>();
+    for(auto i = std::size_t(0); i != partials.size(); ++i) {
+      heads[i].m_position = 0;
+      heads[i].m_keys.resize(key_columns.size());
+      heads[i].m_buffers.resize(key_columns.size());
+      if(!partials[i].empty()) {
+        load(i);
+        heap.push_back(i);
+      }
+    }
+    std::make_heap(heap.begin(), heap.end(), is_after);
+    while(!heap.empty() && count != limit) {
+      std::pop_heap(heap.begin(), heap.end(), is_after);
+      auto shard = heap.back();
+      auto& head = heads[shard];
+      *destination = std::move(partials[shard][head.m_position]);
+      ++destination;
+      ++count;
+      ++head.m_position;
+      if(head.m_position == partials[shard].size()) {
+        heap.pop_back();
+      } else {
+        load(shard);
+        std::push_heap(heap.begin(), heap.end(), is_after);
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef VIPER_PARALLEL_SELECT_HPP
+#define VIPER_PARALLEL_SELECT_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Viper/ConnectionPool.hpp"
+#include "Viper/OrderedMerge.hpp"
+#include "Viper/SelectStatement.hpp"
+#include "Viper/ThreadPool.hpp"
+#include "Viper/DataTypes/DateTimeDataType.hpp"
+#include "Viper/Expressions/Expressions.hpp"
+
+namespace Viper {
+namespace Details {
+  template<typename K>
+  std::int64_t to_scan_key(const K& key) {
+    if constexpr(std::is_same_v<K, DateTime>) {
+      return static_cast<std::int64_t>(key.get_ticks());
+    } else {
+      return static_cast<std::int64_t>(key);
+    }
+  }
+
+  template<typename K>
+  K from_scan_key(std::int64_t key) {
+    if constexpr(std::is_same_v<K, DateTime>) {
+      return DateTime(static_cast<std::uint64_t>(key));
+    } else {
+      return static_cast<K>(key);
+    }
+  }
+
+  inline SelectClause restrict_range(const SelectClause& clause,
+      Expression range) {
+    auto where = clause.get_where() ? *clause.get_where() && std::move(range) :
+      std::move(range);
+    auto& order = clause.get_order();
+    auto& limit = clause.get_limit();
+    if(order && limit) {
+      return select(clause.get_columns(), clause.get_from(), std::move(where),
+        Order(*order), Limit(*limit));
+    } else if(order) {
+      return select(clause.get_columns(), clause.get_from(), std::move(where),
+        Order(*order));
+    } else if(limit) {
+      return select(clause.get_columns(), clause.get_from(), std::move(where),
+        Limit(*limit));
+    }
+    return select(clause.get_columns(), clause.get_from(), std::move(where));
+  }
+
+  template<typename K, typename C>
+  std::optional<K> select_bound(C& connection, const SelectClause& clause,
+      Row<std::optional<K>> row) {
+    auto bound = std::optional<K>();
+    if(clause.get_where()) {
+      connection.execute(select(std::move(row), clause.get_from(),
+        *clause.get_where(), &bound));
+    } else {
+      connection.execute(select(std::move(row), clause.get_from(), &bound));
+    }
+    return bound;
+  }
+
+  inline bool is_ordered_by_key(const SelectClause& clause,
+      const std::string& key) {
+    auto& order = clause.get_order();
+    return !order || order->m_columns.empty() ||
+      (order->m_columns.front().m_name == key &&
+        order->m_columns.front().m_order == Order::ASC);
+  }
+}
+
+  //! Specifies how the rows of a parallel select are delivered.
+  enum class ScanMode {
+
+    //! Rows are written to the statement's destination from the calling
+    //! thread in the order the statement specifies.
+    ORDERED,
+
+    //! Each range writes its rows to a copy of the statement's destination
+    //! as they are fetched, concurrently with the other ranges. The
+    //! statement's order and limit apply within each range.
+    CONCURRENT
+  };
+
+  //! Executes a select by splitting an integer or DateTime key column into
+  //! ranges, each of which is selected on its own pooled connection.
+  /*!
+    \param connections The pool providing a connection to each range.
+    \param threads The threads selecting the ranges.
+    \param statement The statement to execute, its where clause is combined
+           with each range's bounds.
+    \param key The name of the key column to split.
+    \param boundaries The ascending keys separating consecutive ranges, such
+           as sampled quantiles of the key column.
+    \param mode How the selected rows are delivered.
+  */
+  template<typename K, typename C, typename R, typename D>
+  void parallel_select(ConnectionPool<C>& connections, ThreadPool& threads,
+      const SelectStatement<R, D>& statement, const std::string& key,
+      std::vector<K> boundaries, ScanMode mode = ScanMode::ORDERED) {
+    using Type = typename R::Type;
+    auto& clause = statement.get_clause();
+    auto count = boundaries.size() + 1;
+    auto get_range = [&] (std::size_t index) {
+      if(count == 1) {
+        return clause;
+      } else if(index == 0) {
+        return Details::restrict_range(clause,
+          sym(key) < boundaries.front() || sym(key + " IS NULL"));
+      } else if(index == count - 1) {
+        return Details::restrict_range(clause,
+          sym(key) >= boundaries.back());
+      }
+      return Details::restrict_range(clause,
+        sym(key) >= boundaries[index - 1] && sym(key) < boundaries[index]);
+    };
+    if(mode == ScanMode::CONCURRENT) {
+      threads.parallel_for(count, [&] (std::size_t index) {
+        auto connection = connections.acquire();
+        connection->execute(SelectStatement(statement.get_row(),
+          get_range(index), statement.get_first()));
+      });
+      return;
+    }
+    auto partials = std::vector<std::vector<Type>>();
+    if(!Details::is_ordered_by_key(clause, key)) {
+      partials.resize(count);
+      threads.parallel_for(count, [&] (std::size_t index) {
+        auto connection = connections.acquire();
+        connection->execute(SelectStatement(statement.get_row(),
+          get_range(index), std::back_inserter(partials[index])));
+      });
+      merge_ordered(statement.get_row(), clause, partials,
+        statement.get_first());
+      return;
+    }
+    auto limit = std::numeric_limits<std::size_t>::max();
+    if(clause.get_limit() && clause.get_limit()->m_value >= 0) {
+      limit = static_cast<std::size_t>(clause.get_limit()->m_value);
+    }
+    auto wave = std::min(count, threads.get_size() + 1);
+    auto destination = statement.get_first();
+    auto written = std::size_t(0);
+    for(auto first = std::size_t(0); first < count && written != limit;
+        first += wave) {
+      auto size = std::min(wave, count - first);
+      partials.resize(size);
+      threads.parallel_for(size, [&] (std::size_t index) {
+        partials[index].clear();
+        auto connection = connections.acquire();
+        connection->execute(SelectStatement(statement.get_row(),
+          get_range(first + index), std::back_inserter(partials[index])));
+      });
+      for(auto& partial : partials) {
+        for(auto& value : partial) {
+          if(written == limit) {
+            return;
+          }
+          *destination = std::move(value);
+          ++destination;
+          ++written;
+        }
+      }
+    }
+  }
+
+  //! Executes a select by splitting an integer or DateTime key column into
+  //! equally wide ranges between its minimum and maximum, each of which is
+  //! selected on its own pooled connection.
+  /*!
+    \param connections The pool providing a connection to each range.
+    \param threads The threads selecting the ranges.
+    \param statement The statement to execute, its where clause is combined
+           with each range's bounds.
+    \param key The name of the key column to split.
+    \param ranges The number of ranges to split the key column into.
+    \param mode How the selected rows are delivered.
+  */
+  template<typename K, typename C, typename R, typename D>
+  void parallel_select(ConnectionPool<C>& connections, ThreadPool& threads,
+      const SelectStatement<R, D>& statement, const std::string& key,
+      std::size_t ranges, ScanMode mode = ScanMode::ORDERED) {
+    auto boundaries = std::vector<K>();
+    {
+      auto connection = connections.acquire();
+      auto lower = Details::select_bound(*connection, statement.get_clause(),
+        Viper::min<K>(key));
+      auto upper = Details::select_bound(*connection, statement.get_clause(),
+        Viper::max<K>(key));
+      if(lower && upper && ranges > 1) {
+        auto low = Details::to_scan_key(*lower);
+        auto width = static_cast<long double>(Details::to_scan_key(*upper)) -
+          low + 1;
+        for(auto i = std::size_t(1); i != ranges; ++i) {
+          auto boundary = low + static_cast<std::int64_t>(width * i / ranges);
+          if(boundary > low && (boundaries.empty() ||
+              Details::to_scan_key(boundaries.back()) < boundary)) {
+            boundaries.push_back(Details::from_scan_key<K>(boundary));
+          }
+        }
+      }
+    }
+    parallel_select(connections, threads, statement, key,
+      std::move(boundaries), mode);
+  }
+}
+
+#endif
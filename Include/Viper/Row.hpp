@@ -102,6 +102,16 @@ namespace Viper {
       void append_value(const Type& value, int column,
         std::string& query) const;
 
+      //! Stores a value's column in its native representation.
+      /*!
+        \param value The value to store.
+        \param column The index of the column to store.
+        \param destination The raw column to store the value in.
+        \param buffer Stores any bytes referenced by the <i>destination</i>.
+      */
+      void store_value(const Type& value, int column, RawColumn& destination,
+        std::string& buffer) const;
+
       //! Appends a column.
       /*!
         \param name The name of the column.
@@ -319,12 +329,16 @@ namespace Viper {
       template<typename> friend class Row;
       struct Accessors {
         std::function<void (const Type& value, std::string& columns)> m_getter;
+        std::function<void (const Type& value, RawColumn& column,
+          std::string& buffer)> m_raw_getter;
         std::function<void (Type& value, const RawColumn* row)> m_setter;
         int m_count;
 
         Accessors(std::function<void (const Type& value, std::string& columns)>
-          getter, std::function<void (Type& value, const RawColumn* columns)>
-          setter, int count);
+          getter, std::function<void (const Type& value, RawColumn& column,
+          std::string& buffer)> raw_getter,
+          std::function<void (Type& value, const RawColumn* columns)> setter,
+          int count);
       };
       struct Data {
         std::vector<Column> m_columns;
@@ -336,6 +350,17 @@ namespace Viper {
       Row clone() const;
   };
 
+  /** Trait that tests if a type defines a row in an SQL table. */
+  template<typename T>
+  struct is_row : std::false_type {};
+
+  template<typename T>
+  struct is_row<Row<T>> : std::true_type {};
+
+  /** Trait that tests if a type defines a row in an SQL table. */
+  template<typename T>
+  constexpr auto is_row_v = is_row<T>::value;
+
   //! Makes a getter function from a class method.
   template<typename T, typename R>
   auto make_getter(R (T::* getter)() const) {
@@ -411,8 +436,11 @@ namespace Viper {
   template<typename T>
   Row<T>::Accessors::Accessors(
       std::function<void (const Type& value, std::string& columns)> getter,
+      std::function<void (const Type& value, RawColumn& column,
+        std::string& buffer)> raw_getter,
       std::function<void (Type& value, const RawColumn* row)> setter, int count)
       : m_getter(std::move(getter)),
+        m_raw_getter(std::move(raw_getter)),
         m_setter(std::move(setter)),
         m_count(count) {}
 
@@ -451,6 +479,12 @@ namespace Viper {
     m_data->m_accessors[column].m_getter(value, query);
   }
 
+  template<typename T>
+  void Row<T>::store_value(const Type& value, int column,
+      RawColumn& destination, std::string& buffer) const {
+    m_data->m_accessors[column].m_raw_getter(value, destination, buffer);
+  }
+
   template<typename T>
   Row<T> Row<T>::add_column(std::string name) const {
     return add_column(std::move(name), native_to_data_type_v<T>);
@@ -485,10 +519,13 @@ namespace Viper {
       std::string name, const DataType& t, G&& getter, S&& setter) const {
     auto r = clone();
     r.m_data->m_columns.emplace_back(std::move(name), t, false);
+    auto proper_getter = make_getter<Type>(std::forward<G>(getter));
     r.m_data->m_accessors.emplace_back(
-      [getter = make_getter<Type>(std::forward<G>(getter))] (
-          const Type& value, std::string& columns) {
-        to_sql(getter(value), columns);
+      [=] (const Type& value, std::string& columns) {
+        to_sql(proper_getter(value), columns);
+      },
+      [=] (const Type& value, RawColumn& column, std::string& buffer) {
+        to_raw_column(proper_getter(value), column, buffer);
       },
       [setter = make_setter<Type, getter_result_t<G, Type>>(
           std::forward<S>(setter))] (Type& value, const RawColumn* row) {
@@ -542,6 +579,9 @@ namespace Viper {
         [=] (auto& value, auto& columns) {
           return accessor.m_getter(proper_getter(value), columns);
         },
+        [=] (auto& value, auto& column, auto& buffer) {
+          return accessor.m_raw_getter(proper_getter(value), column, buffer);
+        },
         [=] (auto& value, auto columns) {
           decltype(auto) r = proper_getter(value);
           accessor.m_setter(remove_const(r), columns);
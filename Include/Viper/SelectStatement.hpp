@@ -48,8 +48,9 @@ namespace Viper {
     \param from The table to select from.
     \param first An output iterator used to store the rows.
   */
-  template<typename T, typename D>
-  auto select(Row<T> row, FromClause from, D first) {
+  template<typename T, typename D,
+    typename = std::enable_if_t<is_row_v<T>>>
+  auto select(T row, FromClause from, D first) {
     auto columns = std::vector<std::string>();
     for(auto& c : row.get_columns()) {
       columns.push_back(c.m_name);
@@ -65,8 +66,9 @@ namespace Viper {
     \param c1 The first clause.
     \param first An output iterator used to store the rows.
   */
-  template<typename T, typename D, typename C1>
-  auto select(Row<T> row, FromClause from, C1&& c1, D first) {
+  template<typename T, typename D, typename C1,
+    typename = std::enable_if_t<is_row_v<T>>>
+  auto select(T row, FromClause from, C1&& c1, D first) {
     auto columns = std::vector<std::string>();
     for(auto& c : row.get_columns()) {
       columns.push_back(c.m_name);
@@ -83,8 +85,9 @@ namespace Viper {
     \param c2 The second clause.
     \param first An output iterator used to store the rows.
   */
-  template<typename T, typename D, typename C1, typename C2>
-  auto select(Row<T> row, FromClause from, C1&& c1, C2&& c2, D first) {
+  template<typename T, typename D, typename C1, typename C2,
+    typename = std::enable_if_t<is_row_v<T>>>
+  auto select(T row, FromClause from, C1&& c1, C2&& c2, D first) {
     auto columns = std::vector<std::string>();
     for(auto& c : row.get_columns()) {
       columns.push_back(c.m_name);
@@ -102,8 +105,9 @@ namespace Viper {
     \param c3 The third clause.
     \param first An output iterator used to store the rows.
   */
-  template<typename T, typename D, typename C1, typename C2, typename C3>
-  auto select(Row<T> row, FromClause from, C1&& c1, C2&& c2, C3&& c3, D first) {
+  template<typename T, typename D, typename C1, typename C2, typename C3,
+    typename = std::enable_if_t<is_row_v<T>>>
+  auto select(T row, FromClause from, C1&& c1, C2&& c2, C3&& c3, D first) {
     auto columns = std::vector<std::string>();
     for(auto& c : row.get_columns()) {
       columns.push_back(c.m_name);
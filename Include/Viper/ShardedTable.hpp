@@ -0,0 +1,260 @@
+#ifndef VIPER_SHARDED_TABLE_HPP
+#define VIPER_SHARDED_TABLE_HPP
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Viper/CreateTableStatement.hpp"
+#include "Viper/DeleteStatement.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/InsertRangeStatement.hpp"
+#include "Viper/OrderedMerge.hpp"
+#include "Viper/SelectStatement.hpp"
+#include "Viper/ThreadPool.hpp"
+#include "Viper/UpdateStatement.hpp"
+#include "Viper/UpsertStatement.hpp"
+
+namespace Viper {
+
+  /*! \brief Spreads a table's rows over several databases, routing writes to
+             the shard each row belongs to and running selects on every shard
+             in parallel.
+      \tparam C The type of connection to each shard.
+      \tparam T The type of value stored in the table.
+   */
+  template<typename C, typename T>
+  class ShardedTable {
+    public:
+
+      //! The type of connection to each shard.
+      using Connection = C;
+
+      //! The type of value stored in the table.
+      using Type = T;
+
+      //! Returns the shard a value belongs to, reduced modulo the number of
+      //! shards.
+      using ShardFunction = std::function<std::size_t (const Type&)>;
+
+      //! Constructs a sharded table using up to one thread per shard.
+      /*!
+        \param shards The connections to each shard.
+        \param shard Returns the shard a value belongs to, typically by
+               hashing a key column.
+      */
+      ShardedTable(std::vector<Connection> shards, ShardFunction shard);
+
+      //! Constructs a sharded table.
+      /*!
+        \param shards The connections to each shard.
+        \param shard Returns the shard a value belongs to, typically by
+               hashing a key column.
+        \param threads The number of threads used in addition to the calling
+               thread.
+      */
+      ShardedTable(std::vector<Connection> shards, ShardFunction shard,
+        std::size_t threads);
+
+      //! Returns the number of shards.
+      std::size_t get_shard_count() const;
+
+      //! Returns the connection to a shard.
+      /*!
+        \param index The index of the shard.
+      */
+      Connection& get_shard(std::size_t index);
+
+      //! Opens the connection to every shard.
+      void open();
+
+      //! Closes the connection to every shard.
+      void close();
+
+      //! Creates the table on every shard.
+      /*!
+        \param statement The statement to execute.
+      */
+      template<typename R>
+      void execute(const CreateTableStatement<R>& statement);
+
+      //! Deletes from every shard.
+      /*!
+        \param statement The statement to execute.
+      */
+      void execute(const DeleteStatement& statement);
+
+      //! Updates every shard.
+      /*!
+        \param statement The statement to execute.
+      */
+      void execute(const UpdateStatement& statement);
+
+      //! Inserts each value into the shard it belongs to.
+      /*!
+        \param statement The statement to execute.
+      */
+      template<typename R, typename B, typename E>
+      void execute(const InsertRangeStatement<R, B, E>& statement);
+
+      //! Upserts each value into the shard it belongs to.
+      /*!
+        \param statement The statement to execute.
+      */
+      template<typename R, typename B, typename E>
+      void execute(const UpsertStatement<R, B, E>& statement);
+
+      //! Selects from every shard in parallel, merging the results according
+      //! to the statement's order by and limit clauses. Every column ordered
+      //! by must be selected.
+      /*!
+        \param statement The statement to execute.
+      */
+      template<typename R, typename D>
+      void execute(const SelectStatement<R, D>& statement);
+
+    private:
+      std::vector<Connection> m_shards;
+      ShardFunction m_shard;
+      std::vector<std::vector<Type>> m_partitions;
+      ThreadPool m_threads;
+
+      ShardedTable(const ShardedTable&) = delete;
+      ShardedTable& operator =(const ShardedTable&) = delete;
+      template<typename B, typename E>
+      void partition(B begin, E end);
+      template<typename S>
+      void broadcast(const S& statement);
+  };
+
+  template<typename C, typename T>
+  ShardedTable<C, T>::ShardedTable(std::vector<Connection> shards,
+      ShardFunction shard)
+      : ShardedTable(std::move(shards), std::move(shard),
+          std::numeric_limits<std::size_t>::max()) {}
+
+  template<typename C, typename T>
+  ShardedTable<C, T>::ShardedTable(std::vector<Connection> shards,
+      ShardFunction shard, std::size_t threads)
+      : m_shards(std::move(shards)),
+        m_shard(std::move(shard)),
+        m_partitions(m_shards.size()),
+        m_threads(std::min({threads,
+          std::max<std::size_t>(1, std::thread::hardware_concurrency()) - 1,
+          std::max<std::size_t>(1, m_shards.size()) - 1})) {
+    if(m_shards.empty()) {
+      throw ExecuteException("A sharded table requires at least one shard.");
+    }
+  }
+
+  template<typename C, typename T>
+  std::size_t ShardedTable<C, T>::get_shard_count() const {
+    return m_shards.size();
+  }
+
+  template<typename C, typename T>
+  typename ShardedTable<C, T>::Connection&
+      ShardedTable<C, T>::get_shard(std::size_t index) {
+    return m_shards[index];
+  }
+
+  template<typename C, typename T>
+  void ShardedTable<C, T>::open() {
+    m_threads.parallel_for(m_shards.size(), [&] (std::size_t index) {
+      m_shards[index].open();
+    });
+  }
+
+  template<typename C, typename T>
+  void ShardedTable<C, T>::close() {
+    for(auto& shard : m_shards) {
+      shard.close();
+    }
+  }
+
+  template<typename C, typename T>
+  template<typename R>
+  void ShardedTable<C, T>::execute(const CreateTableStatement<R>& statement) {
+    broadcast(statement);
+  }
+
+  template<typename C, typename T>
+  void ShardedTable<C, T>::execute(const DeleteStatement& statement) {
+    broadcast(statement);
+  }
+
+  template<typename C, typename T>
+  void ShardedTable<C, T>::execute(const UpdateStatement& statement) {
+    broadcast(statement);
+  }
+
+  template<typename C, typename T>
+  template<typename R, typename B, typename E>
+  void ShardedTable<C, T>::execute(
+      const InsertRangeStatement<R, B, E>& statement) {
+    static_assert(std::is_same_v<typename R::Type, Type>);
+    partition(statement.get_begin(), statement.get_end());
+    m_threads.parallel_for(m_shards.size(), [&] (std::size_t index) {
+      auto& values = m_partitions[index];
+      if(!values.empty()) {
+        m_shards[index].execute(insert(statement.get_row(),
+          statement.get_table(), values.begin(), values.end()));
+      }
+    });
+  }
+
+  template<typename C, typename T>
+  template<typename R, typename B, typename E>
+  void ShardedTable<C, T>::execute(
+      const UpsertStatement<R, B, E>& statement) {
+    static_assert(std::is_same_v<typename R::Type, Type>);
+    partition(statement.get_begin(), statement.get_end());
+    m_threads.parallel_for(m_shards.size(), [&] (std::size_t index) {
+      auto& values = m_partitions[index];
+      if(!values.empty()) {
+        m_shards[index].execute(upsert(statement.get_row(),
+          statement.get_table(), values.begin(), values.end()));
+      }
+    });
+  }
+
+  template<typename C, typename T>
+  template<typename R, typename D>
+  void ShardedTable<C, T>::execute(const SelectStatement<R, D>& statement) {
+    auto partials =
+      std::vector<std::vector<typename R::Type>>(m_shards.size());
+    m_threads.parallel_for(m_shards.size(), [&] (std::size_t index) {
+      m_shards[index].execute(SelectStatement(statement.get_row(),
+        statement.get_clause(), std::back_inserter(partials[index])));
+    });
+    merge_ordered(statement.get_row(), statement.get_clause(),
+      partials, statement.get_first());
+  }
+
+  template<typename C, typename T>
+  template<typename B, typename E>
+  void ShardedTable<C, T>::partition(B begin, E end) {
+    for(auto& values : m_partitions) {
+      values.clear();
+    }
+    for(; begin != end; ++begin) {
+      auto&& value = *begin;
+      m_partitions[m_shard(value) % m_shards.size()].push_back(value);
+    }
+  }
+
+  template<typename C, typename T>
+  template<typename S>
+  void ShardedTable<C, T>::broadcast(const S& statement) {
+    m_threads.parallel_for(m_shards.size(), [&] (std::size_t index) {
+      m_shards[index].execute(statement);
+    });
+  }
+}
+
+#endif
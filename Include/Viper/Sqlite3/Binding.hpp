@@ -0,0 +1,45 @@
+#ifndef VIPER_SQLITE3_BINDING_HPP
+#define VIPER_SQLITE3_BINDING_HPP
+#include <string>
+#include <sqlite3.h>
+#include "Viper/Conversions.hpp"
+#include "Viper/ExecuteException.hpp"
+
+namespace Viper::Sqlite3 {
+
+  //! Binds a raw column to a parameter of a prepared statement.
+  /*!
+    \param statement The statement to bind the parameter to.
+    \param index The 1-based index of the parameter.
+    \param column The value to bind, any bytes it references must remain valid
+           until the statement is stepped.
+  */
+  inline void bind(::sqlite3_stmt* statement, int index,
+      const RawColumn& column) {
+    auto result = SQLITE_OK;
+    if(is_null(column)) {
+      result = ::sqlite3_bind_null(statement, index);
+    } else if(column.m_type == RawColumn::Type::TEXT) {
+      result = ::sqlite3_bind_text(statement, index, column.m_data,
+        static_cast<int>(column.m_size), SQLITE_STATIC);
+    } else if(column.m_type == RawColumn::Type::BLOB) {
+      result = ::sqlite3_bind_blob(statement, index, column.m_data,
+        static_cast<int>(column.m_size), SQLITE_STATIC);
+    } else if(column.m_type == RawColumn::Type::INTEGER) {
+      result = ::sqlite3_bind_int64(statement, index, column.m_integer);
+    } else if(column.m_type == RawColumn::Type::REAL) {
+      result = ::sqlite3_bind_double(statement, index, column.m_real);
+    } else if(column.m_type == RawColumn::Type::DATE_TIME) {
+      char value[DATE_TIME_CHARS];
+      auto last = to_chars(value,
+        DateTime(static_cast<std::uint64_t>(column.m_integer)));
+      result = ::sqlite3_bind_text(statement, index, value,
+        static_cast<int>(last - value), SQLITE_TRANSIENT);
+    }
+    if(result != SQLITE_OK) {
+      throw ExecuteException(::sqlite3_errmsg(::sqlite3_db_handle(statement)));
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef VIPER_SQLITE3_BULK_INGEST_HPP
+#define VIPER_SQLITE3_BULK_INGEST_HPP
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Viper/Index.hpp"
+#include "Viper/Row.hpp"
+#include "Viper/Transaction.hpp"
+#include "Viper/Sqlite3/Connection.hpp"
+#include "Viper/Sqlite3/QueryBuilder.hpp"
+
+namespace Viper::Sqlite3 {
+
+  /*! \brief Switches a connection into a mode favouring bulk writes over
+             durability for the lifetime of this object, restoring the
+             previous mode afterwards.
+   */
+  class BulkIngest {
+    public:
+
+      //! Stores the pragmas used while ingesting.
+      struct Settings {
+
+        //! The journal mode to use.
+        std::string m_journal_mode = "OFF";
+
+        //! The synchronous level, 0 corresponds to OFF.
+        int m_synchronous = 0;
+
+        //! The cache size, negative values are measured in KiB.
+        int m_cache_size = -262144;
+
+        //! Where temporary tables and indexes are stored, 2 corresponds to
+        //! MEMORY.
+        int m_temp_store = 2;
+
+        //! The locking mode to use.
+        std::string m_locking_mode = "EXCLUSIVE";
+      };
+
+      //! Enters bulk ingest mode with the default settings.
+      /*!
+        \param connection The open connection to ingest with, which must not
+               be in a transaction.
+      */
+      explicit BulkIngest(Connection& connection);
+
+      //! Enters bulk ingest mode.
+      /*!
+        \param connection The open connection to ingest with, which must not
+               be in a transaction.
+        \param settings The pragmas to use while ingesting.
+      */
+      BulkIngest(Connection& connection, const Settings& settings);
+
+      //! Enters bulk ingest mode with the default settings, dropping a
+      //! table's secondary indexes until the ingest is over.
+      /*!
+        \param connection The open connection to ingest with, which must not
+               be in a transaction.
+        \param row The row whose secondary indexes are dropped.
+        \param table The name of the table whose indexes are dropped.
+      */
+      template<typename R, typename = std::enable_if_t<is_row_v<R>>>
+      BulkIngest(Connection& connection, const R& row, std::string table);
+
+      //! Enters bulk ingest mode, dropping a table's secondary indexes until
+      //! the ingest is over.
+      /*!
+        \param connection The open connection to ingest with, which must not
+               be in a transaction.
+        \param row The row whose secondary indexes are dropped.
+        \param table The name of the table whose indexes are dropped.
+        \param settings The pragmas to use while ingesting.
+      */
+      template<typename R, typename = std::enable_if_t<is_row_v<R>>>
+      BulkIngest(Connection& connection, const R& row, std::string table,
+        const Settings& settings);
+
+      //! Rebuilds any dropped indexes and restores the previous pragmas,
+      //! ignoring errors.
+      ~BulkIngest();
+
+      //! Rebuilds any dropped indexes and restores the previous pragmas.
+      void close();
+
+    private:
+      Connection* m_connection;
+      Settings m_previous;
+      std::string m_table;
+      std::vector<Index> m_indexes;
+      bool m_is_open;
+
+      BulkIngest(const BulkIngest&) = delete;
+      BulkIngest& operator =(const BulkIngest&) = delete;
+      void open(const Settings& settings);
+      template<typename T>
+      T get_pragma(const std::string& name);
+      void set_pragma(const std::string& name, const std::string& value);
+      void set_pragmas(const Settings& settings);
+      void restore();
+  };
+
+  inline BulkIngest::BulkIngest(Connection& connection)
+      : BulkIngest(connection, Settings()) {}
+
+  inline BulkIngest::BulkIngest(Connection& connection,
+      const Settings& settings)
+      : m_connection(&connection),
+        m_is_open(false) {
+    open(settings);
+  }
+
+  template<typename R, typename>
+  BulkIngest::BulkIngest(Connection& connection, const R& row,
+      std::string table)
+      : BulkIngest(connection, row, std::move(table), Settings()) {}
+
+  template<typename R, typename>
+  BulkIngest::BulkIngest(Connection& connection, const R& row,
+      std::string table, const Settings& settings)
+      : m_connection(&connection),
+        m_table(std::move(table)),
+        m_is_open(false) {
+    for(auto& index : row.get_indexes()) {
+      if(!index.m_is_primary) {
+        m_indexes.push_back(index);
+      }
+    }
+    open(settings);
+  }
+
+  inline BulkIngest::~BulkIngest() {
+    try {
+      close();
+    } catch(...) {}
+  }
+
+  inline void BulkIngest::close() {
+    if(!m_is_open) {
+      return;
+    }
+    m_is_open = false;
+    auto query = std::string();
+    for(auto& index : m_indexes) {
+      build_create_index_query(m_table, index, query);
+    }
+    try {
+      if(!query.empty()) {
+        transaction(*m_connection, [&] {
+          m_connection->execute(query);
+        });
+      }
+    } catch(...) {
+      restore();
+      throw;
+    }
+    restore();
+  }
+
+  inline void BulkIngest::open(const Settings& settings) {
+    m_previous.m_journal_mode = get_pragma<std::string>("journal_mode");
+    m_previous.m_synchronous = get_pragma<int>("synchronous");
+    m_previous.m_cache_size = get_pragma<int>("cache_size");
+    m_previous.m_temp_store = get_pragma<int>("temp_store");
+    m_previous.m_locking_mode = get_pragma<std::string>("locking_mode");
+    set_pragmas(settings);
+    m_is_open = true;
+    try {
+      auto query = std::string();
+      for(auto& index : m_indexes) {
+        build_drop_index_query(m_table, index, query);
+      }
+      m_connection->execute(query);
+    } catch(...) {
+      m_is_open = false;
+      restore();
+      throw;
+    }
+  }
+
+  template<typename T>
+  T BulkIngest::get_pragma(const std::string& name) {
+    auto value = T();
+    m_connection->execute(select(Row<T>(name), "pragma_" + name, &value));
+    return value;
+  }
+
+  inline void BulkIngest::set_pragma(const std::string& name,
+      const std::string& value) {
+    auto query = std::string("PRAGMA ");
+    query += name;
+    query += " = ";
+    query += value;
+    query += ';';
+    m_connection->execute(query);
+  }
+
+  inline void BulkIngest::restore() {
+    set_pragmas(m_previous);
+    m_connection->execute("SELECT 1 FROM sqlite_master LIMIT 1;");
+  }
+
+  inline void BulkIngest::set_pragmas(const Settings& settings) {
+    set_pragma("journal_mode", settings.m_journal_mode);
+    set_pragma("synchronous", std::to_string(settings.m_synchronous));
+    set_pragma("cache_size", std::to_string(settings.m_cache_size));
+    set_pragma("temp_store", std::to_string(settings.m_temp_store));
+    set_pragma("locking_mode", settings.m_locking_mode);
+  }
+}
+
+#endif
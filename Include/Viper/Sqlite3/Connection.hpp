@@ -1,19 +1,33 @@
 #ifndef VIPER_SQLITE3_CONNECTION_HPP
 #define VIPER_SQLITE3_CONNECTION_HPP
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <string>
+#include <vector>
 #include <sqlite3.h>
+#include "Viper/BatchLimits.hpp"
 #include "Viper/CommitStatement.hpp"
 #include "Viper/ConnectException.hpp"
 #include "Viper/CreateTableStatement.hpp"
+#include "Viper/Cursor.hpp"
 #include "Viper/DeleteStatement.hpp"
 #include "Viper/ExecuteException.hpp"
+#include "Viper/GetMany.hpp"
 #include "Viper/InsertRangeStatement.hpp"
 #include "Viper/RollbackStatement.hpp"
 #include "Viper/SelectStatement.hpp"
 #include "Viper/StartTransactionStatement.hpp"
 #include "Viper/Transaction.hpp"
+#include "Viper/UpdateStatement.hpp"
+#include "Viper/Sqlite3/Binding.hpp"
 #include "Viper/Sqlite3/DataTypeName.hpp"
+#include "Viper/Sqlite3/Fetch.hpp"
+#include "Viper/Sqlite3/PreparedStatement.hpp"
 #include "Viper/Sqlite3/QueryBuilder.hpp"
+#include "Viper/Sqlite3/ResultSet.hpp"
+#include "Viper/Sqlite3/StatementCache.hpp"
+#include "Viper/Sqlite3/TemporaryKeySets.hpp"
 
 namespace Viper::Sqlite3 {
 
@@ -27,6 +41,14 @@ namespace Viper::Sqlite3 {
       */
       Connection(std::string path);
 
+      //! Constructs a connection to an SQLite database.
+      /*!
+        \param path The path to the database.
+        \param flags The flags passed to <code>sqlite3_open_v2</code>, such
+               as <code>SQLITE_OPEN_READONLY</code>.
+      */
+      Connection(std::string path, int flags);
+
       //! Moves a SQLite connection.
       Connection(Connection&& connection);
 
@@ -85,6 +107,43 @@ namespace Viper::Sqlite3 {
       template<typename T, typename D>
       void execute(const SelectStatement<T, D>& s);
 
+      //! Appends the SQL a select statement is executed with, rendering its
+      //! IN lists as literals rather than staging them.
+      /*!
+        \param statement The statement to render.
+        \param query The string to append the SQL to.
+      */
+      template<typename T, typename D>
+      void append_query(const SelectStatement<T, D>& statement,
+        std::string& query) const;
+
+      //! Executes a select whose rows are fetched only as they are iterated
+      //! over.
+      /*!
+        \param row The type of row to select.
+        \param from The table to select from.
+        \param clauses The clauses, such as a where or limit, to select with.
+        \return A cursor over the selected rows, which must be destroyed
+                before this connection is closed or moved.
+      */
+      template<typename R, typename... C>
+      Cursor<R, ResultSet> query(R row, FromClause from, C&&... clauses);
+
+      //! Selects the rows matching a range of primary keys, issuing one query
+      //! per chunk of keys that fits within the batch limits.
+      /*!
+        \param row The type of row to select, it must have a primary key.
+        \param table The name of the table to select from.
+        \param keys_begin An iterator to the first key, a std::tuple or
+               std::pair for a composite primary key.
+        \param keys_end An iterator to one past the last key.
+        \param out The destination written with a std::optional row for each
+               key, in key order, left empty where no row matches the key.
+      */
+      template<typename R, typename B, typename E, typename O>
+      void get_many(const R& row, const std::string& table, B keys_begin,
+        E keys_end, O out);
+
       //! Starts a transaction.
       /*!
         \param statement The statement to execute.
@@ -103,30 +162,140 @@ namespace Viper::Sqlite3 {
       */
       void execute(const RollbackStatement& statement);
 
+      //! Compiles a select statement so that it can be executed repeatedly.
+      /*!
+        \param s The statement to compile, its parameters are bound when the
+               prepared select is executed.
+        \return The prepared select, which must not be executed once
+                this connection is closed.
+      */
+      template<typename T, typename D>
+      PreparedSelect<T, D> prepare(const SelectStatement<T, D>& s);
+
+      //! Compiles a delete statement so that it can be executed repeatedly.
+      /*!
+        \param s The statement to compile, its parameters are bound when the
+               prepared statement is executed.
+        \return The prepared statement, which must not be executed once
+                this connection is closed.
+      */
+      PreparedStatement prepare(const DeleteStatement& s);
+
+      //! Compiles an update statement so that it can be executed repeatedly.
+      /*!
+        \param statement The statement to compile, its parameters are bound
+               when the prepared statement is executed.
+        \return The prepared statement, which must not be executed once
+                this connection is closed.
+      */
+      PreparedStatement prepare(const UpdateStatement& statement);
+
+      //! Returns the usage statistics of the prepared statement cache used by
+      //! selects, updates and deletes.
+      const StatementCache::Statistics& get_statement_cache_statistics() const;
+
+      //! Sets the maximum number of prepared statements to keep compiled.
+      /*!
+        \param capacity The number of statements to cache, a capacity of 0
+               disables caching.
+      */
+      void set_statement_cache_capacity(std::size_t capacity);
+
+      //! Returns the limits insert and upsert batches must fit within.
+      const BatchLimits& get_batch_limits() const;
+
+      //! Sets the limits insert and upsert batches must fit within, once
+      //! opened they are further bounded by the database's own limits.
+      /*!
+        \param limits The limits to write batches within.
+      */
+      void set_batch_limits(const BatchLimits& limits);
+
+      //! Returns the batches written by inserts and upserts.
+      const BatchStatistics& get_batch_statistics() const;
+
+      //! Returns the smallest number of keys in an IN expression that are
+      //! staged in a temporary table rather than rendered as literals.
+      std::size_t get_key_set_threshold() const;
+
+      //! Sets the smallest number of keys in an IN expression that are staged
+      //! in a temporary table rather than rendered as literals.
+      /*!
+        \param threshold The smallest number of keys to stage.
+      */
+      void set_key_set_threshold(std::size_t threshold);
+
+      //! Returns the time spent retrying a statement while the database is
+      //! locked by another connection.
+      std::chrono::milliseconds get_busy_timeout() const;
+
+      //! Sets the time spent retrying a statement while the database is
+      //! locked by another connection before failing with SQLITE_BUSY.
+      /*!
+        \param timeout The busy timeout, a timeout of 0 fails immediately.
+      */
+      void set_busy_timeout(std::chrono::milliseconds timeout);
+
       //! Opens a connection to the SQLite database.
       void open();
 
       //! Closes the connection to the SQLite database.
       void close();
 
+      //! Tests if the connection is open and able to run a query.
+      bool ping();
+
+      //! Rolls back any transaction left open, so that the connection can be
+      //! handed to another user.
+      void reset();
+
     private:
       std::string m_path;
+      int m_flags;
+      std::chrono::milliseconds m_busy_timeout;
       ::sqlite3* m_handle;
       int m_transaction_count;
+      StatementCache m_statements;
+      StatementCache m_write_statements;
+      BatchLimits m_batch_limits;
+      BatchStatistics m_batch_statistics;
+      WriteBuffer m_write_buffer;
+      TemporaryKeySets m_key_sets;
 
       Connection(const Connection&) = delete;
       Connection& operator =(const Connection&) = delete;
+      template<typename S>
+      void write(const S& statement);
+      template<typename S>
+      KeySetLease stage_query(const S& statement, std::string& query);
+      void clamp_batch_limits();
+      void step(const std::string& query);
+      ::sqlite3_stmt* compile(const std::string& query);
   };
 
   inline Connection::Connection(std::string path)
+      : Connection(std::move(path),
+          SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE) {}
+
+  inline Connection::Connection(std::string path, int flags)
       : m_path(std::move(path)),
+        m_flags(flags),
+        m_busy_timeout(0),
         m_handle(nullptr),
         m_transaction_count(0) {}
 
   inline Connection::Connection(Connection&& connection)
       : m_path(std::move(connection.m_path)),
+        m_flags(connection.m_flags),
+        m_busy_timeout(connection.m_busy_timeout),
         m_handle(connection.m_handle),
-        m_transaction_count(connection.m_transaction_count) {
+        m_transaction_count(connection.m_transaction_count),
+        m_statements(std::move(connection.m_statements)),
+        m_write_statements(std::move(connection.m_write_statements)),
+        m_batch_limits(connection.m_batch_limits),
+        m_batch_statistics(connection.m_batch_statistics),
+        m_write_buffer(std::move(connection.m_write_buffer)),
+        m_key_sets(std::move(connection.m_key_sets)) {
     connection.m_handle = nullptr;
     connection.m_transaction_count = 0;
   }
@@ -139,15 +308,8 @@ namespace Viper::Sqlite3 {
     auto escaped_name = std::string();
     escape(name, escaped_name);
     auto query = "PRAGMA table_info(" + escaped_name + ");";
-    auto statement = static_cast<::sqlite3_stmt*>(nullptr);
-    auto result = ::sqlite3_prepare_v2(m_handle, query.c_str(), -1, &statement,
-      nullptr);
-    if(result != SQLITE_OK) {
-      throw ExecuteException(::sqlite3_errmsg(m_handle));
-    }
-    auto has_table = ((result = ::sqlite3_step(statement)) == SQLITE_ROW);
-    ::sqlite3_finalize(statement);
-    return has_table;
+    auto statement = m_statements.get(m_handle, query);
+    return ::sqlite3_step(statement.get()) == SQLITE_ROW;
   }
 
   inline void Connection::execute(std::string_view s) {
@@ -174,107 +336,68 @@ namespace Viper::Sqlite3 {
 
   inline void Connection::execute(const DeleteStatement& s) {
     std::string query;
-    build_query(s, query);
-    execute(query);
+    auto key_sets = stage_query(s, query);
+    step(query);
   }
 
   template<typename T, typename B, typename E>
   void Connection::execute(const InsertRangeStatement<T, B, E>& s) {
-    constexpr auto MAX_WRITES = std::size_t(300);
-    auto count = std::distance(s.get_begin(), s.get_end());
-    transaction(*this, [&] {
-      auto i = s.get_begin();
-      while(count != 0) {
-        auto sub_count = std::min<std::size_t>(MAX_WRITES, count);
-        auto e = i;
-        std::advance(e, sub_count);
-        auto sub_range = insert(s.get_row(), s.get_table(), i, e);
-        auto query = std::string();
-        build_query(sub_range, query);
-        execute(query);
-        std::advance(i, sub_count);
-        count -= sub_count;
-      }
-    });
+    write(s);
   }
 
   inline void Connection::execute(const UpdateStatement& statement) {
     auto query = std::string();
-    build_query(statement, query);
-    execute(query);
+    auto key_sets = stage_query(statement, query);
+    step(query);
   }
 
   template<typename T, typename B, typename E>
   void Connection::execute(const UpsertStatement<T, B, E>& statement) {
-    constexpr auto MAX_WRITES = std::size_t(300);
-    auto count = std::distance(statement.get_begin(), statement.get_end());
-    transaction(*this, [&] {
-      auto i = statement.get_begin();
-      while(count != 0) {
-        auto sub_count = std::min<std::size_t>(MAX_WRITES, count);
-        auto e = i;
-        std::advance(e, sub_count);
-        auto sub_range = upsert(statement.get_row(), statement.get_table(), i, e);
-        auto query = std::string();
-        build_query(sub_range, query);
-        execute(query);
-        std::advance(i, sub_count);
-        count -= sub_count;
-      }
-    });
+    write(statement);
   }
 
   template<typename T, typename D>
   void Connection::execute(const SelectStatement<T, D>& s) {
     std::string query;
-    build_query(s, query);
+    auto key_sets = stage_query(s, query);
     if(query.empty()) {
       return;
     }
-    auto statement = static_cast<::sqlite3_stmt*>(nullptr);
-    auto result = ::sqlite3_prepare_v2(m_handle, query.c_str(), -1, &statement,
-      nullptr);
-    if(result != SQLITE_OK) {
-      throw ExecuteException(::sqlite3_errmsg(m_handle));
-    }
-    auto destination = s.get_first();
-    std::vector<RawColumn> columns;
-    columns.reserve(s.get_row().get_columns().size());
-    while((result = ::sqlite3_step(statement)) == SQLITE_ROW) {
-      columns.clear();
-      for(auto i = 0; i != static_cast<int>(s.get_row().get_columns().size());
-          ++i) {
-        struct TypeVisitor final : DataTypeVisitor {
-          ::sqlite3_stmt* m_statement;
-          int m_index;
-          std::vector<RawColumn>* m_columns;
-
-          void visit(const BlobDataType& t) override {
-            auto data = ::sqlite3_column_blob(m_statement, this->m_index);
-            auto size = ::sqlite3_column_bytes(m_statement, this->m_index);
-            m_columns->push_back(RawColumn{reinterpret_cast<const char*>(data),
-              static_cast<std::size_t>(size)});
-          }
+    auto statement = m_statements.get(m_handle, query);
+    auto plan = std::vector<FetchKind>();
+    build_fetch_plan(s.get_row().get_columns(), plan);
+    auto columns = std::vector<RawColumn>();
+    fetch(statement.get(), plan, s.get_row(), s.get_first(), columns);
+  }
 
-          void visit(const DataType& t) override {
-            auto data = ::sqlite3_column_text(m_statement, this->m_index);
-            m_columns->emplace_back(RawColumn{
-              reinterpret_cast<const char*>(data), 0});
-          }
-        };
-        TypeVisitor visitor;
-        visitor.m_statement = statement;
-        visitor.m_index = i;
-        visitor.m_columns = &columns;
-        auto& column = s.get_row().get_columns()[i];
-        column.m_type->apply(visitor);
-      }
-      auto value = typename SelectStatement<T, D>::Row::Type();
-      s.get_row().extract(columns.data(), value);
-      *destination = std::move(value);
-      ++destination;
+  template<typename T, typename D>
+  void Connection::append_query(const SelectStatement<T, D>& statement,
+      std::string& query) const {
+    build_query(statement, query);
+  }
+
+  template<typename R, typename... C>
+  Cursor<R, ResultSet> Connection::query(R row, FromClause from,
+      C&&... clauses) {
+    auto columns = std::vector<std::string>();
+    for(auto& column : row.get_columns()) {
+      columns.push_back(column.m_name);
     }
-    ::sqlite3_finalize(statement);
+    auto statement = select(std::move(columns), std::move(from),
+      std::forward<C>(clauses)...);
+    auto query = std::string();
+    auto key_sets = stage_query(statement, query);
+    query += ';';
+    auto result_set = ResultSet(m_statements.get(m_handle, query),
+      row.get_columns(), std::move(key_sets));
+    return Cursor<R, ResultSet>(std::move(row), std::move(result_set));
+  }
+
+  template<typename R, typename B, typename E, typename O>
+  void Connection::get_many(const R& row, const std::string& table,
+      B keys_begin, E keys_end, O out) {
+    Viper::get_many(*this, row, table, std::move(keys_begin),
+      std::move(keys_end), std::move(out), m_batch_limits);
   }
 
   inline void Connection::execute(const StartTransactionStatement& statement) {
@@ -303,25 +426,181 @@ namespace Viper::Sqlite3 {
     execute(query);
   }
 
+  template<typename T, typename D>
+  PreparedSelect<T, D> Connection::prepare(const SelectStatement<T, D>& s) {
+    auto query = std::string();
+    auto key_sets = stage_query(s, query);
+    return PreparedSelect<T, D>(compile(query), s.get_row(), s.get_first(),
+      std::move(key_sets));
+  }
+
+  inline PreparedStatement Connection::prepare(const DeleteStatement& s) {
+    auto query = std::string();
+    auto key_sets = stage_query(s, query);
+    return PreparedStatement(compile(query), std::move(key_sets));
+  }
+
+  inline PreparedStatement Connection::prepare(
+      const UpdateStatement& statement) {
+    auto query = std::string();
+    auto key_sets = stage_query(statement, query);
+    return PreparedStatement(compile(query), std::move(key_sets));
+  }
+
+  inline const StatementCache::Statistics&
+      Connection::get_statement_cache_statistics() const {
+    return m_statements.get_statistics();
+  }
+
+  inline void Connection::set_statement_cache_capacity(std::size_t capacity) {
+    m_statements.set_capacity(capacity);
+  }
+
+  inline const BatchLimits& Connection::get_batch_limits() const {
+    return m_batch_limits;
+  }
+
+  inline void Connection::set_batch_limits(const BatchLimits& limits) {
+    m_batch_limits = limits;
+    if(m_handle != nullptr) {
+      clamp_batch_limits();
+    }
+  }
+
+  inline const BatchStatistics& Connection::get_batch_statistics() const {
+    return m_batch_statistics;
+  }
+
+  inline std::size_t Connection::get_key_set_threshold() const {
+    return m_key_sets.get_threshold();
+  }
+
+  inline void Connection::set_key_set_threshold(std::size_t threshold) {
+    m_key_sets.set_threshold(threshold);
+  }
+
+  inline std::chrono::milliseconds Connection::get_busy_timeout() const {
+    return m_busy_timeout;
+  }
+
+  inline void Connection::set_busy_timeout(
+      std::chrono::milliseconds timeout) {
+    m_busy_timeout = timeout;
+    if(m_handle != nullptr) {
+      ::sqlite3_busy_timeout(m_handle,
+        static_cast<int>(m_busy_timeout.count()));
+    }
+  }
+
   inline void Connection::open() {
     if(m_handle != nullptr) {
       return;
     }
-    auto result = ::sqlite3_open(m_path.c_str(), &m_handle);
+    auto result = ::sqlite3_open_v2(m_path.c_str(), &m_handle, m_flags,
+      nullptr);
     if(result != SQLITE_OK) {
-      auto message = ::sqlite3_errmsg(m_handle);
+      auto message = std::string(::sqlite3_errmsg(m_handle));
       ::sqlite3_close(m_handle);
       m_handle = nullptr;
       throw ConnectException(message);
     }
+    ::sqlite3_busy_timeout(m_handle, static_cast<int>(m_busy_timeout.count()));
+    clamp_batch_limits();
   }
 
   inline void Connection::close() {
     if(m_handle == nullptr) {
       return;
     }
-    ::sqlite3_close(m_handle);
+    m_statements.clear();
+    m_write_statements.clear();
+    ::sqlite3_close_v2(m_handle);
     m_handle = nullptr;
+    m_key_sets.clear();
+  }
+
+  inline bool Connection::ping() {
+    return m_handle != nullptr &&
+      ::sqlite3_exec(m_handle, "SELECT 1;", nullptr, nullptr, nullptr) ==
+        SQLITE_OK;
+  }
+
+  inline void Connection::reset() {
+    if(m_transaction_count != 0) {
+      execute(rollback());
+    }
+  }
+
+  template<typename S>
+  void Connection::write(const S& statement) {
+    auto& query = m_write_buffer.m_query;
+    auto prepared_count = std::size_t(0);
+    auto column_count = statement.get_row().get_columns().size();
+    transaction(*this, [&] {
+      write_batches(statement, m_batch_limits, m_write_buffer,
+        m_batch_statistics,
+        [&] (std::size_t count, const RawColumn* parameters) {
+          if(count != prepared_count) {
+            query.clear();
+            build_prepared_query(statement, count, query);
+            prepared_count = count;
+          }
+          auto prepared_statement = m_write_statements.get(m_handle, query);
+          for(auto i = std::size_t(0); i != count * column_count; ++i) {
+            bind(prepared_statement.get(), static_cast<int>(i + 1),
+              parameters[i]);
+          }
+          if(::sqlite3_step(prepared_statement.get()) != SQLITE_DONE) {
+            throw ExecuteException(::sqlite3_errmsg(m_handle));
+          }
+        });
+    });
+  }
+
+  template<typename S>
+  KeySetLease Connection::stage_query(const S& statement, std::string& query) {
+    auto scope = KeySetScope(m_key_sets.get_threshold());
+    build_query(statement, query);
+    if(scope.get_key_sets().empty()) {
+      return nullptr;
+    }
+    auto subqueries = std::vector<std::string>();
+    auto key_sets = m_key_sets.stage(m_handle, scope.get_key_sets(),
+      subqueries);
+    if(!key_sets) {
+      return nullptr;
+    }
+    scope.set_subqueries(std::move(subqueries));
+    query.clear();
+    build_query(statement, query);
+    return key_sets;
+  }
+
+  inline void Connection::clamp_batch_limits() {
+    m_batch_limits.m_max_parameters = std::min(m_batch_limits.m_max_parameters,
+      static_cast<std::size_t>(
+        ::sqlite3_limit(m_handle, SQLITE_LIMIT_VARIABLE_NUMBER, -1)));
+  }
+
+  inline void Connection::step(const std::string& query) {
+    auto statement = m_statements.get(m_handle, query);
+    auto result = ::sqlite3_step(statement.get());
+    while(result == SQLITE_ROW) {
+      result = ::sqlite3_step(statement.get());
+    }
+    if(result != SQLITE_DONE) {
+      throw ExecuteException(::sqlite3_errmsg(m_handle));
+    }
+  }
+
+  inline ::sqlite3_stmt* Connection::compile(const std::string& query) {
+    auto statement = static_cast<::sqlite3_stmt*>(nullptr);
+    if(::sqlite3_prepare_v3(m_handle, query.c_str(),
+        static_cast<int>(query.size() + 1), SQLITE_PREPARE_PERSISTENT,
+        &statement, nullptr) != SQLITE_OK) {
+      throw ExecuteException(::sqlite3_errmsg(m_handle));
+    }
+    return statement;
   }
 }
 
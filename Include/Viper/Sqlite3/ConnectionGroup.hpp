@@ -0,0 +1,160 @@
+#ifndef VIPER_SQLITE3_CONNECTION_GROUP_HPP
+#define VIPER_SQLITE3_CONNECTION_GROUP_HPP
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <utility>
+#include "Viper/ConnectionPool.hpp"
+#include "Viper/SelectStatement.hpp"
+#include "Viper/Sqlite3/Connection.hpp"
+
+namespace Viper::Sqlite3 {
+
+  /*! \brief Opens a database in WAL mode as a single writer shared by all
+             threads and a pool of read-only connections, so that selects run
+             concurrently with each other and with writes.
+   */
+  class ConnectionGroup {
+    public:
+
+      //! The pool of read-only connections.
+      using ReaderPool = ConnectionPool<Connection>;
+
+      //! Provides exclusive use of a read-only connection.
+      using Reader = ReaderPool::Handle;
+
+      //! The time a statement is retried while the database is locked by
+      //! default.
+      static constexpr auto DEFAULT_BUSY_TIMEOUT =
+        std::chrono::milliseconds(5000);
+
+      //! Constructs a group without opening any connections.
+      /*!
+        \param path The path to the database.
+        \param readers The maximum number of read-only connections.
+        \param busy_timeout The time a statement is retried while the
+               database is locked by another connection.
+      */
+      ConnectionGroup(std::string path, std::size_t readers,
+        std::chrono::milliseconds busy_timeout = DEFAULT_BUSY_TIMEOUT);
+
+      //! Opens the writer and switches the database into WAL mode, readers
+      //! are opened on demand.
+      void open();
+
+      //! Closes the writer, every reader must be returned beforehand.
+      void close();
+
+      //! Executes a select on an idle reader.
+      /*!
+        \param statement The statement to execute.
+      */
+      template<typename T, typename D>
+      void execute(const SelectStatement<T, D>& statement);
+
+      //! Executes any other statement on the writer.
+      /*!
+        \param statement The statement to execute.
+      */
+      template<typename S>
+      void execute(const S& statement);
+
+      //! Checks out an idle reader, waiting for one if all are in use.
+      Reader acquire_reader();
+
+      //! Calls a function with exclusive use of a reader.
+      /*!
+        \param f The function to call with the reader.
+        \return The result of <i>f</i>.
+      */
+      template<typename F>
+      decltype(auto) read(F&& f);
+
+      //! Calls a function with exclusive use of the writer, such as to run
+      //! a transaction spanning several statements.
+      /*!
+        \param f The function to call with the writer.
+        \return The result of <i>f</i>.
+      */
+      template<typename F>
+      decltype(auto) write(F&& f);
+
+      //! Returns the usage statistics of the readers.
+      ReaderPool::Statistics get_reader_statistics() const;
+
+    private:
+      std::string m_path;
+      std::chrono::milliseconds m_busy_timeout;
+      std::mutex m_writer_mutex;
+      Connection m_writer;
+      ReaderPool m_readers;
+
+      ConnectionGroup(const ConnectionGroup&) = delete;
+      ConnectionGroup& operator =(const ConnectionGroup&) = delete;
+  };
+
+  inline ConnectionGroup::ConnectionGroup(std::string path,
+      std::size_t readers, std::chrono::milliseconds busy_timeout)
+      : m_path(std::move(path)),
+        m_busy_timeout(busy_timeout),
+        m_writer(m_path),
+        m_readers(readers, [this] {
+          auto reader = Connection(m_path,
+            SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX);
+          reader.set_busy_timeout(m_busy_timeout);
+          return reader;
+        }) {
+    m_writer.set_busy_timeout(m_busy_timeout);
+  }
+
+  inline void ConnectionGroup::open() {
+    auto lock = std::lock_guard(m_writer_mutex);
+    m_writer.open();
+    try {
+      m_writer.execute("PRAGMA journal_mode = WAL;");
+    } catch(...) {
+      m_writer.close();
+      throw;
+    }
+  }
+
+  inline void ConnectionGroup::close() {
+    auto lock = std::lock_guard(m_writer_mutex);
+    m_writer.close();
+  }
+
+  template<typename T, typename D>
+  void ConnectionGroup::execute(const SelectStatement<T, D>& statement) {
+    acquire_reader()->execute(statement);
+  }
+
+  template<typename S>
+  void ConnectionGroup::execute(const S& statement) {
+    auto lock = std::lock_guard(m_writer_mutex);
+    m_writer.execute(statement);
+  }
+
+  inline ConnectionGroup::Reader ConnectionGroup::acquire_reader() {
+    return m_readers.acquire();
+  }
+
+  template<typename F>
+  decltype(auto) ConnectionGroup::read(F&& f) {
+    auto reader = acquire_reader();
+    return std::forward<F>(f)(*reader);
+  }
+
+  template<typename F>
+  decltype(auto) ConnectionGroup::write(F&& f) {
+    auto lock = std::lock_guard(m_writer_mutex);
+    return std::forward<F>(f)(m_writer);
+  }
+
+  inline ConnectionGroup::ReaderPool::Statistics
+      ConnectionGroup::get_reader_statistics() const {
+    return m_readers.get_statistics();
+  }
+}
+
+#endif
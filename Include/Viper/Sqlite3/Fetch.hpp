@@ -0,0 +1,137 @@
+#ifndef VIPER_SQLITE3_FETCH_HPP
+#define VIPER_SQLITE3_FETCH_HPP
+#include <cstdint>
+#include <vector>
+#include <sqlite3.h>
+#include "Viper/Column.hpp"
+#include "Viper/Conversions.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/DataTypes/DataTypes.hpp"
+
+namespace Viper::Sqlite3 {
+
+  //! Lists the ways a result column can be read.
+  enum class FetchKind : std::uint8_t {
+
+    //! The column is read as text.
+    TEXT,
+
+    //! The column is read as binary data.
+    BLOB,
+
+    //! The column is read as a 64-bit integer.
+    INTEGER,
+
+    //! The column is read as a double.
+    REAL
+  };
+
+  //! Determines how each of a row's columns is read.
+  /*!
+    \param columns The columns of the row being selected.
+    \param plan Stores the way each column is read.
+  */
+  inline void build_fetch_plan(const std::vector<Column>& columns,
+      std::vector<FetchKind>& plan) {
+    struct KindVisitor final : DataTypeVisitor {
+      FetchKind m_kind;
+
+      void visit(const BlobDataType& t) override {
+        m_kind = FetchKind::BLOB;
+      }
+
+      void visit(const DataType& t) override {
+        m_kind = FetchKind::TEXT;
+      }
+
+      void visit(const FloatDataType& t) override {
+        m_kind = FetchKind::REAL;
+      }
+
+      void visit(const IntegerDataType& t) override {
+        m_kind = FetchKind::INTEGER;
+      }
+    };
+    plan.clear();
+    for(auto& column : columns) {
+      auto visitor = KindVisitor();
+      column.m_type->apply(visitor);
+      plan.push_back(visitor.m_kind);
+    }
+  }
+
+  //! Reads the columns of the row a statement is positioned on. Integer and
+  //! floating point columns are read in their native representation, text
+  //! and blobs are passed along with their size.
+  /*!
+    \param statement The statement positioned on a row.
+    \param plan The way each column is read.
+    \param columns Stores the columns read, it must be the size of the
+           <i>plan</i>.
+  */
+  inline void read_row(::sqlite3_stmt* statement,
+      const std::vector<FetchKind>& plan, std::vector<RawColumn>& columns) {
+    auto count = static_cast<int>(plan.size());
+    for(auto i = 0; i != count; ++i) {
+      auto& column = columns[i];
+      if(::sqlite3_column_type(statement, i) == SQLITE_NULL) {
+        column.m_type = RawColumn::Type::NONE;
+        column.m_data = nullptr;
+        column.m_size = 0;
+        continue;
+      }
+      switch(plan[i]) {
+        case FetchKind::TEXT:
+          column.m_type = RawColumn::Type::TEXT;
+          column.m_data = reinterpret_cast<const char*>(
+            ::sqlite3_column_text(statement, i));
+          column.m_size = static_cast<std::size_t>(
+            ::sqlite3_column_bytes(statement, i));
+          break;
+        case FetchKind::BLOB:
+          column.m_type = RawColumn::Type::BLOB;
+          column.m_data = static_cast<const char*>(
+            ::sqlite3_column_blob(statement, i));
+          column.m_size = static_cast<std::size_t>(
+            ::sqlite3_column_bytes(statement, i));
+          break;
+        case FetchKind::INTEGER:
+          column.m_type = RawColumn::Type::INTEGER;
+          column.m_integer = ::sqlite3_column_int64(statement, i);
+          break;
+        case FetchKind::REAL:
+          column.m_type = RawColumn::Type::REAL;
+          column.m_real = ::sqlite3_column_double(statement, i);
+          break;
+      }
+    }
+  }
+
+  //! Steps through the rows of a statement, extracting each one into a
+  //! destination.
+  /*!
+    \param statement The statement to step through.
+    \param plan The way each column is read.
+    \param row The type of row to extract.
+    \param destination An output iterator used to store the rows.
+    \param columns Stores the columns of the row being extracted.
+  */
+  template<typename R, typename D>
+  void fetch(::sqlite3_stmt* statement, const std::vector<FetchKind>& plan,
+      const R& row, D destination, std::vector<RawColumn>& columns) {
+    auto result = SQLITE_OK;
+    columns.resize(plan.size());
+    while((result = ::sqlite3_step(statement)) == SQLITE_ROW) {
+      read_row(statement, plan, columns);
+      auto value = typename R::Type();
+      row.extract(columns.data(), value);
+      *destination = std::move(value);
+      ++destination;
+    }
+    if(result != SQLITE_DONE) {
+      throw ExecuteException(::sqlite3_errmsg(::sqlite3_db_handle(statement)));
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef VIPER_SQLITE3_PREPARED_STATEMENT_HPP
+#define VIPER_SQLITE3_PREPARED_STATEMENT_HPP
+#include <array>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "Viper/Conversions.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/Expressions/InExpression.hpp"
+#include "Viper/Sqlite3/Binding.hpp"
+#include "Viper/Sqlite3/Fetch.hpp"
+
+namespace Viper::Sqlite3 {
+namespace Details {
+  template<typename... A>
+  void bind_arguments(::sqlite3_stmt* statement,
+      std::array<std::string, sizeof...(A)>& buffers, const A&... arguments) {
+    if(static_cast<int>(sizeof...(A)) !=
+        ::sqlite3_bind_parameter_count(statement)) {
+      throw ExecuteException("Parameter count mismatch.");
+    }
+    if constexpr(sizeof...(A) != 0) {
+      auto column = RawColumn();
+      auto index = 0;
+      ((to_raw_column(arguments, column, buffers[index]),
+        bind(statement, index + 1, column), ++index), ...);
+    }
+  }
+}
+
+  //! Keeps a statement compiled so that it can be executed repeatedly with
+  //! new values bound to its parameters.
+  class PreparedStatement {
+    public:
+
+      //! Constructs a prepared statement.
+      /*!
+        \param statement The compiled statement, ownership is transferred to
+               this object.
+        \param key_sets The lease on the key sets the statement reads.
+      */
+      explicit PreparedStatement(::sqlite3_stmt* statement,
+        KeySetLease key_sets = nullptr);
+
+      //! Moves a prepared statement.
+      PreparedStatement(PreparedStatement&& statement);
+
+      ~PreparedStatement();
+
+      //! Returns the number of parameters the statement expects.
+      std::size_t get_parameter_count() const;
+
+      //! Returns the compiled statement.
+      ::sqlite3_stmt* get() const;
+
+      //! Binds values to the parameters in order of appearance and executes
+      //! the statement.
+      /*!
+        \param arguments The values to bind, one per parameter.
+      */
+      template<typename... A>
+      void execute(const A&... arguments);
+
+    private:
+      ::sqlite3_stmt* m_statement;
+      KeySetLease m_key_sets;
+
+      PreparedStatement(const PreparedStatement&) = delete;
+      PreparedStatement& operator =(const PreparedStatement&) = delete;
+  };
+
+  /*! \brief Keeps a select statement compiled so that it can be executed
+             repeatedly with new values bound to its parameters.
+      \tparam R The type of row to select.
+      \tparam D The output iterator to store the rows in.
+   */
+  template<typename R, typename D>
+  class PreparedSelect {
+    public:
+
+      //! The type of row to select.
+      using Row = R;
+
+      //! The output iterator to store the rows in.
+      using Destination = D;
+
+      //! Constructs a prepared select.
+      /*!
+        \param statement The compiled statement, ownership is transferred to
+               this object.
+        \param row The type of row to select.
+        \param first An output iterator used to store the rows.
+        \param key_sets The lease on the key sets the statement reads.
+      */
+      PreparedSelect(::sqlite3_stmt* statement, Row row, Destination first,
+        KeySetLease key_sets = nullptr);
+
+      //! Returns the number of parameters the statement expects.
+      std::size_t get_parameter_count() const;
+
+      //! Binds values to the parameters in order of appearance and stores the
+      //! selected rows in the destination.
+      /*!
+        \param arguments The values to bind, one per parameter.
+      */
+      template<typename... A>
+      void execute(const A&... arguments);
+
+    private:
+      PreparedStatement m_statement;
+      Row m_row;
+      Destination m_first;
+      std::vector<FetchKind> m_plan;
+      std::vector<RawColumn> m_columns;
+  };
+
+  inline PreparedStatement::PreparedStatement(::sqlite3_stmt* statement,
+      KeySetLease key_sets)
+      : m_statement(statement),
+        m_key_sets(std::move(key_sets)) {}
+
+  inline PreparedStatement::PreparedStatement(PreparedStatement&& statement)
+      : m_statement(statement.m_statement),
+        m_key_sets(std::move(statement.m_key_sets)) {
+    statement.m_statement = nullptr;
+  }
+
+  inline PreparedStatement::~PreparedStatement() {
+    ::sqlite3_finalize(m_statement);
+  }
+
+  inline std::size_t PreparedStatement::get_parameter_count() const {
+    return static_cast<std::size_t>(
+      ::sqlite3_bind_parameter_count(m_statement));
+  }
+
+  inline ::sqlite3_stmt* PreparedStatement::get() const {
+    return m_statement;
+  }
+
+  template<typename... A>
+  void PreparedStatement::execute(const A&... arguments) {
+    auto buffers = std::array<std::string, sizeof...(A)>();
+    Details::bind_arguments(m_statement, buffers, arguments...);
+    auto result = ::sqlite3_step(m_statement);
+    while(result == SQLITE_ROW) {
+      result = ::sqlite3_step(m_statement);
+    }
+    ::sqlite3_reset(m_statement);
+    if(result != SQLITE_DONE) {
+      throw ExecuteException(
+        ::sqlite3_errmsg(::sqlite3_db_handle(m_statement)));
+    }
+  }
+
+  template<typename R, typename D>
+  PreparedSelect<R, D>::PreparedSelect(::sqlite3_stmt* statement, Row row,
+      Destination first, KeySetLease key_sets)
+      : m_statement(statement, std::move(key_sets)),
+        m_row(std::move(row)),
+        m_first(std::move(first)) {
+    build_fetch_plan(m_row.get_columns(), m_plan);
+  }
+
+  template<typename R, typename D>
+  std::size_t PreparedSelect<R, D>::get_parameter_count() const {
+    return m_statement.get_parameter_count();
+  }
+
+  template<typename R, typename D>
+  template<typename... A>
+  void PreparedSelect<R, D>::execute(const A&... arguments) {
+    auto buffers = std::array<std::string, sizeof...(A)>();
+    Details::bind_arguments(m_statement.get(), buffers, arguments...);
+    try {
+      fetch(m_statement.get(), m_plan, m_row, m_first, m_columns);
+    } catch(...) {
+      ::sqlite3_reset(m_statement.get());
+      throw;
+    }
+    ::sqlite3_reset(m_statement.get());
+  }
+}
+
+#endif
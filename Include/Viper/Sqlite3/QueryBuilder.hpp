@@ -4,6 +4,7 @@
 #include "Viper/CommitStatement.hpp"
 #include "Viper/CreateTableStatement.hpp"
 #include "Viper/DeleteStatement.hpp"
+#include "Viper/Index.hpp"
 #include "Viper/InsertRangeStatement.hpp"
 #include "Viper/RollbackStatement.hpp"
 #include "Viper/SelectClause.hpp"
@@ -40,8 +41,104 @@ namespace Details {
         query += item;
       });
   }
+
+  template<typename R>
+  void append_parameters(const R& row, const std::string& table,
+      std::size_t count, std::string& query) {
+    constexpr auto FIXED_SIZE = std::size_t(64);
+    auto& columns = row.get_columns();
+    auto size = FIXED_SIZE + table.size() + count * (2 * columns.size() + 2);
+    for(auto& column : columns) {
+      size += 3 * column.m_name.size() + 16;
+    }
+    query.reserve(query.size() + size);
+    query += "INSERT INTO ";
+    query += table;
+    query += " (";
+    append_list(columns, query,
+      [] (const auto& column, auto& query) {
+        query += column.m_name;
+      });
+    query += ") VALUES ";
+    for(auto i = std::size_t(0); i != count; ++i) {
+      if(i != 0) {
+        query += ',';
+      }
+      query += '(';
+      for(auto j = std::size_t(0); j != columns.size(); ++j) {
+        if(j != 0) {
+          query += ',';
+        }
+        query += '?';
+      }
+      query += ')';
+    }
+  }
+
+  template<typename R>
+  void append_conflict_clause(const R& row, std::string& query) {
+    query += " ON CONFLICT(";
+    auto indicies = std::vector<std::string>();
+    for(auto& index : row.get_indexes()) {
+      if(index.m_is_unique) {
+        indicies.insert(indicies.end(), index.m_columns.begin(),
+          index.m_columns.end());
+      }
+    }
+    append_list(indicies, query);
+    query += ") DO UPDATE SET ";
+    append_list(row.get_columns(), query,
+      [&] (const auto& column, auto& query) {
+        auto is_unique = std::find(indicies.begin(), indicies.end(),
+          column.m_name) != indicies.end();
+        if(!is_unique) {
+          query += column.m_name;
+          query += " = excluded.";
+          query += column.m_name;
+        }
+      });
+  }
 }
 
+  //! Builds a query creating a table's secondary index.
+  /*!
+    \param table The name of the table to index.
+    \param index The index to create.
+    \param query The string to store the query in.
+  */
+  inline void build_create_index_query(const std::string& table,
+      const Index& index, std::string& query) {
+    if(index.m_is_unique) {
+      query += "CREATE UNIQUE INDEX";
+    } else {
+      query += "CREATE INDEX";
+    }
+    query += " IF NOT EXISTS ";
+    query += table;
+    query += '_';
+    query += index.m_name;
+    query += " ON ";
+    query += table;
+    query += '(';
+    Details::append_list(index.m_columns, query);
+    query += ");";
+  }
+
+  //! Builds a query dropping a table's secondary index.
+  /*!
+    \param table The name of the indexed table.
+    \param index The index to drop.
+    \param query The string to store the query in.
+  */
+  inline void build_drop_index_query(const std::string& table,
+      const Index& index, std::string& query) {
+    query += "DROP INDEX IF EXISTS ";
+    query += table;
+    query += '_';
+    query += index.m_name;
+    query += ';';
+  }
+
   //! Builds a create table query statement.
   /*!
     \param statement The statement to build.
@@ -54,10 +151,13 @@ namespace Details {
     if(statement.get_exists_flag()) {
       query += "IF NOT EXISTS ";
     }
-    query += statement.get_name() + '(';
+    query += statement.get_name();
+    query += '(';
     Details::append_list(statement.get_row().get_columns(), query,
       [] (const auto& column, auto& query) {
-        query += column.m_name + ' ' + get_name(*column.m_type);
+        query += column.m_name;
+        query += ' ';
+        query += get_name(*column.m_type);
         if(!column.m_is_nullable) {
           query += " NOT NULL";
         }
@@ -71,18 +171,9 @@ namespace Details {
     }
     query += ");";
     for(auto& current_index : statement.get_row().get_indexes()) {
-      if(current_index.m_is_primary) {
-        continue;
-      }
-      if(current_index.m_is_unique) {
-        query += "CREATE UNIQUE INDEX";
-      } else {
-        query += "CREATE INDEX";
+      if(!current_index.m_is_primary) {
+        build_create_index_query(statement.get_name(), current_index, query);
       }
-      query += " IF NOT EXISTS " + statement.get_name() + "_" +
-        current_index.m_name + " ON " + statement.get_name() + "(";
-      Details::append_list(current_index.m_columns, query);
-      query += ");";
     }
   }
 
@@ -93,7 +184,8 @@ namespace Details {
   */
   inline void build_query(const DeleteStatement& statement,
       std::string& query) {
-    query += "DELETE FROM " + statement.get_table();
+    query += "DELETE FROM ";
+    query += statement.get_table();
     if(statement.get_where().has_value()) {
       query += " WHERE ";
       statement.get_where()->append_query(query);
@@ -138,6 +230,23 @@ namespace Details {
     query += ';';
   }
 
+  //! Builds an insert query whose values are bound as parameters.
+  /*!
+    \param statement The statement whose row and table are inserted into.
+    \param count The number of rows of parameters to insert.
+    \param query The string to store the query in.
+  */
+  template<typename T, typename B, typename E>
+  void build_prepared_query(const InsertRangeStatement<T, B, E>& statement,
+      std::size_t count, std::string& query) {
+    if(count == 0 || statement.get_row().get_columns().empty()) {
+      return;
+    }
+    Details::append_parameters(statement.get_row(), statement.get_table(),
+      count, query);
+    query += ';';
+  }
+
   //! Builds an update statement.
   /*!
     \param statement The statement to build.
@@ -192,26 +301,25 @@ namespace Details {
         }
         query += ')';
       });
-    query += " ON CONFLICT(";
-    auto indicies = std::vector<std::string>();
-    for(auto& index : statement.get_row().get_indexes()) {
-      if(index.m_is_unique) {
-        indicies.insert(indicies.end(), index.m_columns.begin(),
-          index.m_columns.end());
-      }
+    Details::append_conflict_clause(statement.get_row(), query);
+    query += ';';
+  }
+
+  //! Builds an upsert query whose values are bound as parameters.
+  /*!
+    \param statement The statement whose row and table are upserted into.
+    \param count The number of rows of parameters to upsert.
+    \param query The string to store the query in.
+  */
+  template<typename T, typename B, typename E>
+  void build_prepared_query(const UpsertStatement<T, B, E>& statement,
+      std::size_t count, std::string& query) {
+    if(count == 0 || statement.get_row().get_columns().empty()) {
+      return;
     }
-    Details::append_list(indicies, query);
-    query += ") DO UPDATE SET ";
-    Details::append_list(statement.get_row().get_columns(), query,
-      [&] (const auto& column, auto& query) {
-        auto is_unique = std::find(indicies.begin(), indicies.end(),
-          column.m_name) != indicies.end();
-        if(!is_unique) {
-          query += column.m_name;
-          query += " = ";
-          query += "excluded." + column.m_name;
-        }
-      });
+    Details::append_parameters(statement.get_row(), statement.get_table(),
+      count, query);
+    Details::append_conflict_clause(statement.get_row(), query);
     query += ';';
   }
 
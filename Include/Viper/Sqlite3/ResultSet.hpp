@@ -0,0 +1,71 @@
+#ifndef VIPER_SQLITE3_RESULT_SET_HPP
+#define VIPER_SQLITE3_RESULT_SET_HPP
+#include <vector>
+#include <sqlite3.h>
+#include "Viper/Column.hpp"
+#include "Viper/Conversions.hpp"
+#include "Viper/ExecuteException.hpp"
+#include "Viper/Expressions/InExpression.hpp"
+#include "Viper/Sqlite3/Fetch.hpp"
+#include "Viper/Sqlite3/StatementCache.hpp"
+
+namespace Viper::Sqlite3 {
+
+  //! Steps through the rows of a statement on demand.
+  class ResultSet {
+    public:
+
+      //! Constructs a result set.
+      /*!
+        \param statement The statement to step through.
+        \param columns The columns of the row being selected.
+        \param key_sets The lease on the key sets the statement reads.
+      */
+      ResultSet(StatementCache::Statement statement,
+        const std::vector<Column>& columns, KeySetLease key_sets = nullptr);
+
+      //! Moves a result set.
+      ResultSet(ResultSet&& result_set) = default;
+
+      //! Steps to the next row.
+      /*!
+        \return <code>true</code> iff a row was fetched.
+      */
+      bool fetch();
+
+      //! Returns the columns of the most recently fetched row.
+      const RawColumn* get_columns() const;
+
+    private:
+      StatementCache::Statement m_statement;
+      KeySetLease m_key_sets;
+      std::vector<FetchKind> m_plan;
+      std::vector<RawColumn> m_columns;
+  };
+
+  inline ResultSet::ResultSet(StatementCache::Statement statement,
+      const std::vector<Column>& columns, KeySetLease key_sets)
+      : m_statement(std::move(statement)),
+        m_key_sets(std::move(key_sets)) {
+    build_fetch_plan(columns, m_plan);
+    m_columns.resize(m_plan.size());
+  }
+
+  inline bool ResultSet::fetch() {
+    auto result = ::sqlite3_step(m_statement.get());
+    if(result == SQLITE_ROW) {
+      read_row(m_statement.get(), m_plan, m_columns);
+      return true;
+    } else if(result != SQLITE_DONE) {
+      throw ExecuteException(
+        ::sqlite3_errmsg(::sqlite3_db_handle(m_statement.get())));
+    }
+    return false;
+  }
+
+  inline const RawColumn* ResultSet::get_columns() const {
+    return m_columns.data();
+  }
+}
+
+#endif
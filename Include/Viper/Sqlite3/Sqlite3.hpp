@@ -1,8 +1,16 @@
 #ifndef VIPER_SQLITE3_HPP
 #define VIPER_SQLITE3_HPP
 #include "Viper/Viper.hpp"
+#include "Viper/Sqlite3/Binding.hpp"
+#include "Viper/Sqlite3/BulkIngest.hpp"
 #include "Viper/Sqlite3/Connection.hpp"
+#include "Viper/Sqlite3/ConnectionGroup.hpp"
 #include "Viper/Sqlite3/DataTypeName.hpp"
+#include "Viper/Sqlite3/Fetch.hpp"
+#include "Viper/Sqlite3/PreparedStatement.hpp"
 #include "Viper/Sqlite3/QueryBuilder.hpp"
+#include "Viper/Sqlite3/ResultSet.hpp"
+#include "Viper/Sqlite3/StatementCache.hpp"
+#include "Viper/Sqlite3/TemporaryKeySets.hpp"
 
 #endif
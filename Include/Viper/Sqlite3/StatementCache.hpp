@@ -0,0 +1,240 @@
+#ifndef VIPER_SQLITE3_STATEMENT_CACHE_HPP
+#define VIPER_SQLITE3_STATEMENT_CACHE_HPP
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <sqlite3.h>
+#include "Viper/ExecuteException.hpp"
+
+namespace Viper::Sqlite3 {
+
+  //! Caches compiled SQLite statements keyed by their query text, finalizing
+  //! the least recently used statement once the capacity is exceeded.
+  class StatementCache {
+    private:
+      struct Entry;
+
+    public:
+
+      //! Stores counters measuring the effectiveness of the cache.
+      struct Statistics {
+
+        //! The number of statements that were found in the cache.
+        std::uint64_t m_hits = 0;
+
+        //! The number of statements that had to be compiled.
+        std::uint64_t m_misses = 0;
+
+        //! The number of statements finalized to make room for others.
+        std::uint64_t m_evictions = 0;
+      };
+
+      //! Provides scoped use of a compiled statement, the statement is reset
+      //! and returned to the cache when this object is destroyed.
+      class Statement {
+        public:
+
+          //! Moves a statement.
+          Statement(Statement&& statement);
+
+          ~Statement();
+
+          //! Returns the SQLite statement.
+          ::sqlite3_stmt* get() const;
+
+        private:
+          friend class StatementCache;
+          StatementCache* m_cache;
+          Entry* m_entry;
+          ::sqlite3_stmt* m_statement;
+
+          Statement(StatementCache& cache, Entry* entry,
+            ::sqlite3_stmt* statement);
+          Statement(const Statement&) = delete;
+          Statement& operator =(const Statement&) = delete;
+      };
+
+      //! The number of statements cached by default.
+      static constexpr auto DEFAULT_CAPACITY = std::size_t(64);
+
+      //! Constructs a cache with the default capacity.
+      StatementCache();
+
+      //! Constructs a cache.
+      /*!
+        \param capacity The maximum number of statements to keep compiled, a
+               capacity of 0 disables caching.
+      */
+      explicit StatementCache(std::size_t capacity);
+
+      //! Moves a cache.
+      StatementCache(StatementCache&& cache);
+
+      ~StatementCache();
+
+      //! Returns the maximum number of statements to keep compiled.
+      std::size_t get_capacity() const;
+
+      //! Sets the maximum number of statements to keep compiled.
+      void set_capacity(std::size_t capacity);
+
+      //! Returns the number of statements currently compiled.
+      std::size_t get_size() const;
+
+      //! Returns the usage statistics.
+      const Statistics& get_statistics() const;
+
+      //! Returns a compiled statement, compiling it if it isn't cached.
+      /*!
+        \param handle The database the statement belongs to.
+        \param query The single SQL statement to compile.
+        \return A scoped handle to the compiled statement.
+      */
+      Statement get(::sqlite3* handle, const std::string& query);
+
+      //! Finalizes all cached statements.
+      void clear();
+
+    private:
+      using Entries = std::list<Entry>;
+      struct Entry {
+        std::string m_query;
+        ::sqlite3_stmt* m_statement;
+        bool m_is_busy;
+      };
+      std::size_t m_capacity;
+      Entries m_entries;
+      std::unordered_map<std::string, Entries::iterator> m_index;
+      Statistics m_statistics;
+
+      StatementCache(const StatementCache&) = delete;
+      StatementCache& operator =(const StatementCache&) = delete;
+      void release(Entry* entry, ::sqlite3_stmt* statement);
+      void evict();
+  };
+
+  inline StatementCache::Statement::Statement(Statement&& statement)
+      : m_cache(statement.m_cache),
+        m_entry(statement.m_entry),
+        m_statement(statement.m_statement) {
+    statement.m_statement = nullptr;
+  }
+
+  inline StatementCache::Statement::~Statement() {
+    if(m_statement == nullptr) {
+      return;
+    }
+    m_cache->release(m_entry, m_statement);
+  }
+
+  inline ::sqlite3_stmt* StatementCache::Statement::get() const {
+    return m_statement;
+  }
+
+  inline StatementCache::Statement::Statement(StatementCache& cache,
+      Entry* entry, ::sqlite3_stmt* statement)
+      : m_cache(&cache),
+        m_entry(entry),
+        m_statement(statement) {}
+
+  inline StatementCache::StatementCache()
+      : StatementCache(DEFAULT_CAPACITY) {}
+
+  inline StatementCache::StatementCache(std::size_t capacity)
+      : m_capacity(capacity) {}
+
+  inline StatementCache::StatementCache(StatementCache&& cache)
+      : m_capacity(cache.m_capacity),
+        m_entries(std::move(cache.m_entries)),
+        m_index(std::move(cache.m_index)),
+        m_statistics(cache.m_statistics) {
+    cache.m_entries.clear();
+    cache.m_index.clear();
+  }
+
+  inline StatementCache::~StatementCache() {
+    clear();
+  }
+
+  inline std::size_t StatementCache::get_capacity() const {
+    return m_capacity;
+  }
+
+  inline void StatementCache::set_capacity(std::size_t capacity) {
+    m_capacity = capacity;
+    evict();
+  }
+
+  inline std::size_t StatementCache::get_size() const {
+    return m_entries.size();
+  }
+
+  inline const StatementCache::Statistics&
+      StatementCache::get_statistics() const {
+    return m_statistics;
+  }
+
+  inline StatementCache::Statement StatementCache::get(::sqlite3* handle,
+      const std::string& query) {
+    auto i = m_index.find(query);
+    if(i != m_index.end() && !i->second->m_is_busy) {
+      ++m_statistics.m_hits;
+      m_entries.splice(m_entries.begin(), m_entries, i->second);
+      i->second->m_is_busy = true;
+      return Statement(*this, &*i->second, i->second->m_statement);
+    }
+    ++m_statistics.m_misses;
+    auto statement = static_cast<::sqlite3_stmt*>(nullptr);
+    auto is_cached = m_capacity != 0 && i == m_index.end();
+    auto result = ::sqlite3_prepare_v3(handle, query.c_str(),
+      static_cast<int>(query.size() + 1),
+      is_cached ? SQLITE_PREPARE_PERSISTENT : 0, &statement, nullptr);
+    if(result != SQLITE_OK) {
+      throw ExecuteException(::sqlite3_errmsg(handle));
+    }
+    if(!is_cached) {
+      return Statement(*this, nullptr, statement);
+    }
+    m_entries.push_front(Entry{query, statement, true});
+    m_index.emplace(query, m_entries.begin());
+    evict();
+    return Statement(*this, &m_entries.front(), statement);
+  }
+
+  inline void StatementCache::clear() {
+    for(auto& entry : m_entries) {
+      ::sqlite3_finalize(entry.m_statement);
+    }
+    m_entries.clear();
+    m_index.clear();
+  }
+
+  inline void StatementCache::release(Entry* entry,
+      ::sqlite3_stmt* statement) {
+    if(entry == nullptr) {
+      ::sqlite3_finalize(statement);
+      return;
+    }
+    ::sqlite3_reset(statement);
+    ::sqlite3_clear_bindings(statement);
+    entry->m_is_busy = false;
+    evict();
+  }
+
+  inline void StatementCache::evict() {
+    auto i = m_entries.end();
+    while(m_entries.size() > m_capacity && i != m_entries.begin()) {
+      --i;
+      if(i->m_is_busy) {
+        continue;
+      }
+      ::sqlite3_finalize(i->m_statement);
+      m_index.erase(i->m_query);
+      i = m_entries.erase(i);
+      ++m_statistics.m_evictions;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef VIPER_SQLITE3_TEMPORARY_KEY_SETS_HPP
+#define VIPER_SQLITE3_TEMPORARY_KEY_SETS_HPP
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "Viper/ExecuteException.hpp"
+#include "Viper/Expressions/InExpression.hpp"
+#include "Viper/Sqlite3/Binding.hpp"
+
+namespace Viper::Sqlite3 {
+
+  //! Stages the keys of large IN lists in temporary tables, so that they
+  //! are bound as parameters instead of being parsed as SQL literals.
+  class TemporaryKeySets {
+    public:
+
+      //! The smallest number of keys staged by default.
+      static constexpr auto DEFAULT_THRESHOLD = std::size_t(256);
+
+      //! Constructs an empty set of tables.
+      TemporaryKeySets();
+
+      //! Moves a set of tables, leaving the source empty.
+      TemporaryKeySets(TemporaryKeySets&& key_sets);
+
+      //! Returns the smallest number of keys that are staged.
+      std::size_t get_threshold() const;
+
+      //! Sets the smallest number of keys that are staged.
+      /*!
+        \param threshold The smallest number of keys to stage.
+      */
+      void set_threshold(std::size_t threshold);
+
+      //! Stages key sets in tables that no other query has reserved.
+      /*!
+        \param handle The connection the query is executed on.
+        \param key_sets The key sets to stage.
+        \param subqueries Stores a subquery selecting each staged key set.
+        \return A lease reserving the tables until it is released, or
+                <code>nullptr</code> iff the keys could not be staged.
+      */
+      KeySetLease stage(::sqlite3* handle,
+        const std::vector<const std::vector<RawColumn>*>& key_sets,
+        std::vector<std::string>& subqueries);
+
+      //! Forgets the tables created so far, such as after the connection was
+      //! closed.
+      void clear();
+
+    private:
+      struct Tables {
+        std::vector<bool> m_reservations;
+      };
+      std::size_t m_threshold;
+      std::shared_ptr<Tables> m_tables;
+
+      TemporaryKeySets(const TemporaryKeySets&) = delete;
+      TemporaryKeySets& operator =(const TemporaryKeySets&) = delete;
+      static void execute(::sqlite3* handle, const std::string& query);
+      static void fill(::sqlite3* handle, const std::string& table,
+        const std::vector<RawColumn>& keys);
+  };
+
+  inline TemporaryKeySets::TemporaryKeySets()
+      : m_threshold(DEFAULT_THRESHOLD),
+        m_tables(std::make_shared<Tables>()) {}
+
+  inline TemporaryKeySets::TemporaryKeySets(TemporaryKeySets&& key_sets)
+      : m_threshold(key_sets.m_threshold),
+        m_tables(std::exchange(key_sets.m_tables,
+          std::make_shared<Tables>())) {}
+
+  inline std::size_t TemporaryKeySets::get_threshold() const {
+    return m_threshold;
+  }
+
+  inline void TemporaryKeySets::set_threshold(std::size_t threshold) {
+    m_threshold = threshold;
+  }
+
+  inline KeySetLease TemporaryKeySets::stage(::sqlite3* handle,
+      const std::vector<const std::vector<RawColumn>*>& key_sets,
+      std::vector<std::string>& subqueries) {
+    subqueries.clear();
+    if(handle == nullptr) {
+      return nullptr;
+    }
+    auto tables = m_tables;
+    auto lease = std::shared_ptr<std::vector<std::size_t>>(
+      new std::vector<std::size_t>(),
+      [=] (std::vector<std::size_t>* indexes) {
+        for(auto index : *indexes) {
+          tables->m_reservations[index] = false;
+        }
+        delete indexes;
+      });
+    auto& reservations = tables->m_reservations;
+    try {
+      for(auto keys : key_sets) {
+        auto index = std::size_t(0);
+        while(index != reservations.size() && reservations[index]) {
+          ++index;
+        }
+        auto table = "temp.viper_keys_" + std::to_string(index);
+        if(index == reservations.size()) {
+          execute(handle,
+            "CREATE TEMP TABLE IF NOT EXISTS " + table + "(value);");
+          reservations.push_back(false);
+        }
+        fill(handle, table, *keys);
+        reservations[index] = true;
+        lease->push_back(index);
+        subqueries.push_back("SELECT value FROM " + table);
+      }
+    } catch(const ExecuteException&) {
+      subqueries.clear();
+      return nullptr;
+    }
+    return lease;
+  }
+
+  inline void TemporaryKeySets::clear() {
+    m_tables = std::make_shared<Tables>();
+  }
+
+  inline void TemporaryKeySets::execute(::sqlite3* handle,
+      const std::string& query) {
+    if(::sqlite3_exec(handle, query.c_str(), nullptr, nullptr, nullptr) !=
+        SQLITE_OK) {
+      throw ExecuteException(::sqlite3_errmsg(handle));
+    }
+  }
+
+  inline void TemporaryKeySets::fill(::sqlite3* handle,
+      const std::string& table, const std::vector<RawColumn>& keys) {
+    execute(handle, "SAVEPOINT viper_keys;");
+    auto statement = static_cast<::sqlite3_stmt*>(nullptr);
+    try {
+      execute(handle, "DELETE FROM " + table + ';');
+      auto insert = "INSERT INTO " + table + " VALUES (?);";
+      if(::sqlite3_prepare_v2(handle, insert.c_str(),
+          static_cast<int>(insert.size() + 1), &statement, nullptr) !=
+          SQLITE_OK) {
+        throw ExecuteException(::sqlite3_errmsg(handle));
+      }
+      for(auto& key : keys) {
+        bind(statement, 1, key);
+        if(::sqlite3_step(statement) != SQLITE_DONE) {
+          throw ExecuteException(::sqlite3_errmsg(handle));
+        }
+        ::sqlite3_reset(statement);
+      }
+      ::sqlite3_finalize(statement);
+      statement = nullptr;
+      execute(handle, "RELEASE viper_keys;");
+    } catch(...) {
+      ::sqlite3_finalize(statement);
+      ::sqlite3_exec(handle, "ROLLBACK TO viper_keys; RELEASE viper_keys;",
+        nullptr, nullptr, nullptr);
+      throw;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef VIPER_STATIC_ROW_HPP
+#define VIPER_STATIC_ROW_HPP
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Viper/Column.hpp"
+#include "Viper/Conversions.hpp"
+#include "Viper/Index.hpp"
+#include "Viper/Row.hpp"
+#include "Viper/DataTypes/NativeToDataType.hpp"
+
+namespace Viper {
+namespace Details {
+  template<typename M>
+  struct member_traits;
+
+  template<typename T, typename U>
+  struct member_traits<U T::*> {
+    using Owner = T;
+    using Type = U;
+  };
+}
+
+  /*! \brief Stores a string literal so that it can be used as a template
+             argument.
+      \tparam N The size of the literal, including its null terminator.
+   */
+  template<std::size_t N>
+  struct FixedString {
+
+    //! The characters of the literal.
+    char m_value[N];
+
+    //! Constructs a fixed string from a literal.
+    constexpr FixedString(const char (&value)[N]) {
+      std::copy_n(value, N, m_value);
+    }
+  };
+
+  /*! \brief Ties a column to a data member at compile time.
+      \tparam N The name of the column.
+      \tparam M A pointer to the member to tie the column to.
+   */
+  template<FixedString N, auto M>
+  struct Field {
+
+    //! The type of row the member belongs to.
+    using Owner = typename Details::member_traits<decltype(M)>::Owner;
+
+    //! The type of the member.
+    using Type = typename Details::member_traits<decltype(M)>::Type;
+
+    //! The name of the column.
+    static constexpr auto NAME = N;
+
+    //! A pointer to the member the column is tied to.
+    static constexpr auto MEMBER = M;
+  };
+
+  /*! \brief Defines a row in an SQL table whose columns are all known at
+             compile time, accessing each column directly through its member.
+      \tparam T The type used to represent a row.
+      \tparam F The fields making up the row's columns.
+   */
+  template<typename T, typename... F>
+  class StaticRow {
+    static_assert((std::is_same_v<typename F::Owner, T> && ...),
+      "Fields must be members of the row's type.");
+
+    public:
+
+      //! The type used to represent a row.
+      using Type = T;
+
+      //! Constructs a row without any indexes.
+      StaticRow() = default;
+
+      //! Returns the list of columns.
+      const std::vector<Column>& get_columns() const;
+
+      //! Returns the list of indexes (including the primary key).
+      const std::vector<Index>& get_indexes() const;
+
+      //! Extracts an SQL row.
+      /*!
+        \param row A pointer to the first column to extract.
+        \param value The value to store the rows in.
+      */
+      void extract(const RawColumn* row, Type& value) const;
+
+      //! Appends a value to an SQL query string.
+      /*!
+        \param value The value to append.
+        \param column The index of the column to append.
+        \param query The query string to append the value to.
+      */
+      void append_value(const Type& value, int column,
+        std::string& query) const;
+
+      //! Stores a value's column in its native representation.
+      /*!
+        \param value The value to store.
+        \param column The index of the column to store.
+        \param destination The raw column to store the value in.
+        \param buffer Stores any bytes referenced by the <i>destination</i>.
+      */
+      void store_value(const Type& value, int column, RawColumn& destination,
+        std::string& buffer) const;
+
+      //! Sets the row's primary key.
+      /*!
+        \param columns A column to use as the primary key.
+        \return A new row containing the primary key.
+      */
+      StaticRow set_primary_key(std::string column) const;
+
+      //! Sets the row's primary key.
+      /*!
+        \param columns A list of column names to use as the primary key.
+        \return A new row containing the primary key.
+      */
+      StaticRow set_primary_key(
+        std::initializer_list<std::string> columns) const;
+
+      //! Sets the row's primary key.
+      /*!
+        \param columns A list of column names to use as the primary key.
+        \return A new row containing the primary key.
+      */
+      StaticRow set_primary_key(std::vector<std::string> columns) const;
+
+      //! Adds an index.
+      /*!
+        \param name The name of the index.
+        \param column The column to use as an index.
+        \return A new row containing the index.
+      */
+      StaticRow add_index(std::string name, std::string column) const;
+
+      //! Adds an index.
+      /*!
+        \param name The name of the index.
+        \param columns A list of column names to use as an index.
+        \return A new row containing the index.
+      */
+      StaticRow add_index(std::string name,
+        std::initializer_list<std::string> columns) const;
+
+      //! Adds an index.
+      /*!
+        \param name The name of the index.
+        \param columns A list of column names to use as an index.
+        \return A new row containing the index.
+      */
+      StaticRow add_index(std::string name,
+        std::vector<std::string> columns) const;
+
+    private:
+      std::vector<Index> m_indexes;
+
+      template<std::size_t... I>
+      void append_value(const Type& value, int column, std::string& query,
+        std::index_sequence<I...>) const;
+      template<std::size_t... I>
+      void store_value(const Type& value, int column, RawColumn& destination,
+        std::string& buffer, std::index_sequence<I...>) const;
+  };
+
+  template<typename T, typename... F>
+  struct is_row<StaticRow<T, F...>> : std::true_type {};
+
+  template<typename T, typename... F>
+  const std::vector<Column>& StaticRow<T, F...>::get_columns() const {
+    static const auto columns = std::vector<Column>{
+      Column(F::NAME.m_value, native_to_data_type_v<typename F::Type>,
+        false)...};
+    return columns;
+  }
+
+  template<typename T, typename... F>
+  const std::vector<Index>& StaticRow<T, F...>::get_indexes() const {
+    return m_indexes;
+  }
+
+  template<typename T, typename... F>
+  void StaticRow<T, F...>::extract(const RawColumn* row, Type& value) const {
+    ((value.*F::MEMBER = from_sql<typename F::Type>(*row), ++row), ...);
+  }
+
+  template<typename T, typename... F>
+  void StaticRow<T, F...>::append_value(const Type& value, int column,
+      std::string& query) const {
+    append_value(value, column, query, std::index_sequence_for<F...>());
+  }
+
+  template<typename T, typename... F>
+  void StaticRow<T, F...>::store_value(const Type& value, int column,
+      RawColumn& destination, std::string& buffer) const {
+    store_value(value, column, destination, buffer,
+      std::index_sequence_for<F...>());
+  }
+
+  template<typename T, typename... F>
+  StaticRow<T, F...> StaticRow<T, F...>::set_primary_key(
+      std::string column) const {
+    return set_primary_key({column});
+  }
+
+  template<typename T, typename... F>
+  StaticRow<T, F...> StaticRow<T, F...>::set_primary_key(
+      std::initializer_list<std::string> columns) const {
+    return set_primary_key(std::vector<std::string>{columns});
+  }
+
+  template<typename T, typename... F>
+  StaticRow<T, F...> StaticRow<T, F...>::set_primary_key(
+      std::vector<std::string> columns) const {
+    Index i;
+    i.m_columns = std::move(columns);
+    i.m_is_primary = true;
+    i.m_is_unique = true;
+    auto r = *this;
+    if(!r.m_indexes.empty()) {
+      r.m_indexes.front().m_is_primary = false;
+    }
+    r.m_indexes.insert(r.m_indexes.begin(), std::move(i));
+    return r;
+  }
+
+  template<typename T, typename... F>
+  StaticRow<T, F...> StaticRow<T, F...>::add_index(std::string name,
+      std::string column) const {
+    return add_index(std::move(name), {column});
+  }
+
+  template<typename T, typename... F>
+  StaticRow<T, F...> StaticRow<T, F...>::add_index(std::string name,
+      std::initializer_list<std::string> columns) const {
+    return add_index(std::move(name), std::vector<std::string>{columns});
+  }
+
+  template<typename T, typename... F>
+  StaticRow<T, F...> StaticRow<T, F...>::add_index(std::string name,
+      std::vector<std::string> columns) const {
+    Index i;
+    i.m_name = std::move(name);
+    i.m_columns = std::move(columns);
+    auto r = *this;
+    r.m_indexes.push_back(std::move(i));
+    return r;
+  }
+
+  template<typename T, typename... F>
+  template<std::size_t... I>
+  void StaticRow<T, F...>::append_value(const Type& value, int column,
+      std::string& query, std::index_sequence<I...>) const {
+    ((column == static_cast<int>(I) &&
+      (to_sql(value.*F::MEMBER, query), true)) || ...);
+  }
+
+  template<typename T, typename... F>
+  template<std::size_t... I>
+  void StaticRow<T, F...>::store_value(const Type& value, int column,
+      RawColumn& destination, std::string& buffer,
+      std::index_sequence<I...>) const {
+    ((column == static_cast<int>(I) &&
+      (to_raw_column(value.*F::MEMBER, destination, buffer), true)) || ...);
+  }
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef VIPER_THREAD_POOL_HPP
+#define VIPER_THREAD_POOL_HPP
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Viper {
+
+  //! A fixed set of threads that run the iterations of parallel loops.
+  class ThreadPool {
+    public:
+
+      //! Constructs a pool with one thread per hardware thread.
+      ThreadPool();
+
+      //! Constructs a pool.
+      /*!
+        \param size The number of threads, the thread calling parallel_for
+               also runs iterations so a size of 0 runs loops serially.
+      */
+      explicit ThreadPool(std::size_t size);
+
+      //! Waits for the threads to finish their current tasks.
+      ~ThreadPool();
+
+      //! Returns the number of threads.
+      std::size_t get_size() const;
+
+      //! Calls a function once for every index in a range, running the calls
+      //! concurrently and returning once they have all completed.
+      /*!
+        \param count The number of indexes.
+        \param f The function to call with each index, an exception thrown
+               by any call is rethrown once the remaining calls complete.
+      */
+      template<typename F>
+      void parallel_for(std::size_t count, F&& f);
+
+    private:
+      std::vector<std::thread> m_threads;
+      std::mutex m_mutex;
+      std::condition_variable m_task_condition;
+      std::deque<std::function<void ()>> m_tasks;
+      bool m_is_stopping;
+
+      ThreadPool(const ThreadPool&) = delete;
+      ThreadPool& operator =(const ThreadPool&) = delete;
+      void run();
+  };
+
+  inline ThreadPool::ThreadPool()
+      : ThreadPool(std::max(1U, std::thread::hardware_concurrency())) {}
+
+  inline ThreadPool::ThreadPool(std::size_t size)
+      : m_is_stopping(false) {
+    for(auto i = std::size_t(0); i != size; ++i) {
+      m_threads.emplace_back([this] {
+        run();
+      });
+    }
+  }
+
+  inline ThreadPool::~ThreadPool() {
+    {
+      auto lock = std::lock_guard(m_mutex);
+      m_is_stopping = true;
+    }
+    m_task_condition.notify_all();
+    for(auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  inline std::size_t ThreadPool::get_size() const {
+    return m_threads.size();
+  }
+
+  template<typename F>
+  void ThreadPool::parallel_for(std::size_t count, F&& f) {
+    struct Loop {
+      std::function<void (std::size_t)> m_body;
+      std::size_t m_count;
+      std::atomic<std::size_t> m_next;
+      std::mutex m_mutex;
+      std::condition_variable m_done_condition;
+      std::size_t m_completed;
+      std::exception_ptr m_error;
+
+      void run() {
+        auto index = std::size_t();
+        while((index = m_next++) < m_count) {
+          auto error = std::exception_ptr();
+          try {
+            m_body(index);
+          } catch(...) {
+            error = std::current_exception();
+          }
+          auto lock = std::lock_guard(m_mutex);
+          if(error && !m_error) {
+            m_error = error;
+          }
+          ++m_completed;
+          if(m_completed == m_count) {
+            m_done_condition.notify_all();
+          }
+        }
+      }
+    };
+    if(count == 0) {
+      return;
+    }
+    auto loop = std::make_shared<Loop>();
+    loop->m_body = [&] (std::size_t index) {
+      f(index);
+    };
+    loop->m_count = count;
+    loop->m_next = 0;
+    loop->m_completed = 0;
+    auto helpers = std::min(count - 1, m_threads.size());
+    if(helpers != 0) {
+      {
+        auto lock = std::lock_guard(m_mutex);
+        for(auto i = std::size_t(0); i != helpers; ++i) {
+          m_tasks.push_back([=] {
+            loop->run();
+          });
+        }
+      }
+      m_task_condition.notify_all();
+    }
+    loop->run();
+    auto lock = std::unique_lock(loop->m_mutex);
+    loop->m_done_condition.wait(lock, [&] {
+      return loop->m_completed == loop->m_count;
+    });
+    if(loop->m_error) {
+      std::rethrow_exception(loop->m_error);
+    }
+  }
+
+  inline void ThreadPool::run() {
+    while(true) {
+      auto task = std::function<void ()>();
+      {
+        auto lock = std::unique_lock(m_mutex);
+        m_task_condition.wait(lock, [&] {
+          return m_is_stopping || !m_tasks.empty();
+        });
+        if(m_tasks.empty()) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      }
+      task();
+    }
+  }
+}
+
+#endif
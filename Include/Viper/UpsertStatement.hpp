@@ -1,7 +1,10 @@
 #ifndef VIPER_UPSERT_STATEMENT_HPP
 #define VIPER_UPSERT_STATEMENT_HPP
+#include <ranges>
 #include <string>
+#include <type_traits>
 #include "Viper/Row.hpp"
+#include "Viper/Utilities.hpp"
 
 namespace Viper {
 
@@ -40,10 +43,10 @@ namespace Viper {
       const std::string& get_table() const;
 
       //! Returns the begin iterator.
-      Begin get_begin() const;
+      const Begin& get_begin() const;
 
       //! Returns the end iterator.
-      End get_end() const;
+      const End& get_end() const;
 
     private:
       Row m_row;
@@ -52,7 +55,8 @@ namespace Viper {
       End m_end;
   };
 
-  //! Builds an upsert range statement.
+  //! Builds an upsert range statement, an iterator that can not be copied
+  //! is shared by every copy of the statement.
   /*!
     \param row The type of row to upsert.
     \param table The name of the table to upsert into.
@@ -61,8 +65,9 @@ namespace Viper {
   */
   template<typename R, typename B, typename E>
   auto upsert(R row, std::string table, B begin, E end) {
-    return UpsertStatement(std::move(row), std::move(table), std::move(begin),
-      std::move(end));
+    return UpsertStatement(std::move(row), std::move(table),
+      Details::share_iterator(std::move(begin)),
+      Details::share_iterator(std::move(end)));
   }
 
   //! Builds an upsert statement for a single value.
@@ -76,6 +81,21 @@ namespace Viper {
     return UpsertStatement(std::move(row), std::move(table), value, value + 1);
   }
 
+  //! Builds an upsert statement for every value in a range, the range is
+  //! traversed only once so that values can be streamed from a generator.
+  /*!
+    \param row The type of row to upsert.
+    \param table The name of the table to upsert into.
+    \param range The range of values to upsert, it must remain valid until the
+           statement is executed.
+  */
+  template<typename R, typename G,
+    typename = std::enable_if_t<std::ranges::input_range<G>>>
+  auto upsert(R row, std::string table, G&& range) {
+    return upsert(std::move(row), std::move(table), std::ranges::begin(range),
+      std::ranges::end(range));
+  }
+
   template<typename R, typename B, typename E>
   UpsertStatement<R, B, E>::UpsertStatement(Row row, std::string table,
       Begin begin, End end)
@@ -96,13 +116,13 @@ namespace Viper {
   }
 
   template<typename R, typename B, typename E>
-  typename UpsertStatement<R, B, E>::Begin
+  const typename UpsertStatement<R, B, E>::Begin&
       UpsertStatement<R, B, E>::get_begin() const {
     return m_begin;
   }
 
   template<typename R, typename B, typename E>
-  typename UpsertStatement<R, B, E>::End
+  const typename UpsertStatement<R, B, E>::End&
       UpsertStatement<R, B, E>::get_end() const {
     return m_end;
   }
@@ -1,5 +1,8 @@
 #ifndef VIPER_UTILITIES_HPP
 #define VIPER_UTILITIES_HPP
+#include <concepts>
+#include <iterator>
+#include <memory>
 #include <utility>
 
 namespace Viper {
@@ -22,6 +25,52 @@ namespace Details {
       return std::forward<T2>(b);
     }
   };
+
+  template<typename I>
+  class SharedIterator {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = std::iter_value_t<I>;
+      using difference_type = std::iter_difference_t<I>;
+      using reference = std::iter_reference_t<I>;
+
+      explicit SharedIterator(I iterator)
+        : m_iterator(std::make_shared<I>(std::move(iterator))) {}
+
+      reference operator *() const {
+        return **m_iterator;
+      }
+
+      SharedIterator& operator ++() {
+        ++*m_iterator;
+        return *this;
+      }
+
+      void operator ++(int) {
+        ++*m_iterator;
+      }
+
+      bool operator ==(const SharedIterator& iterator) const {
+        return *m_iterator == *iterator.m_iterator;
+      }
+
+      template<typename S> requires(!std::same_as<S, SharedIterator>)
+      bool operator ==(const S& sentinel) const {
+        return *m_iterator == sentinel;
+      }
+
+    private:
+      std::shared_ptr<I> m_iterator;
+  };
+
+  template<typename I>
+  auto share_iterator(I iterator) {
+    if constexpr(std::copy_constructible<I>) {
+      return iterator;
+    } else {
+      return SharedIterator<I>(std::move(iterator));
+    }
+  }
 }
 
   //! Moves one of two values depending on a compile-time condition.
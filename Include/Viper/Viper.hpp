@@ -2,21 +2,33 @@
 #define VIPER_HPP
 #include "Viper/DataTypes/DataTypes.hpp"
 #include "Viper/Expressions/Expressions.hpp"
+#include "Viper/BatchLimits.hpp"
+#include "Viper/CachedConnection.hpp"
 #include "Viper/Column.hpp"
 #include "Viper/CommitStatement.hpp"
 #include "Viper/ConnectException.hpp"
+#include "Viper/ConnectionPool.hpp"
 #include "Viper/Conversions.hpp"
 #include "Viper/CreateTableStatement.hpp"
+#include "Viper/Cursor.hpp"
 #include "Viper/DeleteStatement.hpp"
 #include "Viper/ExecuteException.hpp"
+#include "Viper/GetMany.hpp"
 #include "Viper/InsertRangeStatement.hpp"
+#include "Viper/MirroredTable.hpp"
+#include "Viper/OrderedMerge.hpp"
+#include "Viper/ParallelSelect.hpp"
 #include "Viper/RollbackStatement.hpp"
 #include "Viper/Row.hpp"
 #include "Viper/SelectStatement.hpp"
+#include "Viper/ShardedTable.hpp"
 #include "Viper/StartTransactionStatement.hpp"
+#include "Viper/StaticRow.hpp"
+#include "Viper/ThreadPool.hpp"
 #include "Viper/Transaction.hpp"
 #include "Viper/Utilities.hpp"
 #include "Viper/UpdateStatement.hpp"
 #include "Viper/UpsertStatement.hpp"
+#include "Viper/WriteBehind.hpp"
 
 #endif
@@ -0,0 +1,479 @@
+#ifndef VIPER_WRITE_BEHIND_HPP
+#define VIPER_WRITE_BEHIND_HPP
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Viper/Conversions.hpp"
+#include "Viper/InsertRangeStatement.hpp"
+#include "Viper/UpsertStatement.hpp"
+
+namespace Viper {
+namespace Details {
+  template<typename T>
+  class MpscQueue {
+    public:
+      explicit MpscQueue(std::size_t capacity)
+          : m_mask(round_capacity(capacity) - 1),
+            m_slots(std::make_unique<Slot[]>(m_mask + 1)),
+            m_tail(0),
+            m_head(0) {
+        for(auto i = std::size_t(0); i != m_mask + 1; ++i) {
+          m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+      }
+
+      bool try_push(T& value) {
+        auto position = m_tail.load(std::memory_order_relaxed);
+        while(true) {
+          auto& slot = m_slots[position & m_mask];
+          auto sequence = slot.m_sequence.load(std::memory_order_acquire);
+          auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+          if(difference == 0) {
+            if(m_tail.compare_exchange_weak(position, position + 1,
+                std::memory_order_relaxed)) {
+              slot.m_value = std::move(value);
+              slot.m_sequence.store(position + 1, std::memory_order_release);
+              return true;
+            }
+          } else if(difference < 0) {
+            return false;
+          } else {
+            position = m_tail.load(std::memory_order_relaxed);
+          }
+        }
+      }
+
+      bool try_pop(T& value) {
+        auto& slot = m_slots[m_head & m_mask];
+        auto sequence = slot.m_sequence.load(std::memory_order_acquire);
+        if(sequence != m_head + 1) {
+          return false;
+        }
+        value = std::move(slot.m_value);
+        slot.m_sequence.store(m_head + m_mask + 1, std::memory_order_release);
+        ++m_head;
+        return true;
+      }
+
+    private:
+      struct Slot {
+        std::atomic<std::size_t> m_sequence;
+        T m_value;
+      };
+      std::size_t m_mask;
+      std::unique_ptr<Slot[]> m_slots;
+      alignas(64) std::atomic<std::size_t> m_tail;
+      alignas(64) std::size_t m_head;
+
+      static std::size_t round_capacity(std::size_t capacity) {
+        auto rounded = std::size_t(2);
+        while(rounded < capacity) {
+          rounded *= 2;
+        }
+        return rounded;
+      }
+  };
+}
+
+  //! Lists the statements a write-behind queue can write its rows with.
+  enum class WriteMode {
+
+    //! Rows are inserted.
+    INSERT,
+
+    //! Rows are upserted, rows sharing a primary key within a flush are
+    //! coalesced so that only the most recent one is written.
+    UPSERT
+  };
+
+  /*! \brief Queues rows to be written to a table by a dedicated thread,
+             so that producers never wait on the database.
+      \tparam C The type of connection to write with.
+      \tparam R The type of row to write.
+   */
+  template<typename C, typename R>
+  class WriteBehind {
+    public:
+
+      //! The type of connection to write with.
+      using Connection = C;
+
+      //! The type of row to write.
+      using Row = R;
+
+      //! The type used to represent a row.
+      using Type = typename Row::Type;
+
+      //! Stores counters measuring the queue's throughput.
+      struct Statistics {
+
+        //! The number of rows waiting in the queue.
+        std::size_t m_depth = 0;
+
+        //! The number of rows pushed onto the queue.
+        std::uint64_t m_enqueued = 0;
+
+        //! The number of rows written to the table.
+        std::uint64_t m_written = 0;
+
+        //! The number of rows superseded by a later row with the same key.
+        std::uint64_t m_coalesced = 0;
+
+        //! The number of flushes written.
+        std::uint64_t m_flushes = 0;
+
+        //! The number of rows a call to try_push rejected because the queue
+        //! was full.
+        std::uint64_t m_rejected = 0;
+
+        //! The number of calls to push that waited for room in the queue.
+        std::uint64_t m_stalls = 0;
+
+        //! The time taken to write the most recent flush.
+        std::chrono::nanoseconds m_last_flush_latency{0};
+
+        //! The longest time taken to write a flush.
+        std::chrono::nanoseconds m_max_flush_latency{0};
+      };
+
+      //! The number of rows the queue holds by default.
+      static constexpr auto DEFAULT_CAPACITY = std::size_t(1) << 16;
+
+      //! The number of queued rows that triggers a flush by default.
+      static constexpr auto DEFAULT_FLUSH_SIZE = std::size_t(1024);
+
+      //! The longest a row waits before being flushed by default.
+      static constexpr auto DEFAULT_FLUSH_INTERVAL =
+        std::chrono::milliseconds(10);
+
+      //! Constructs a write-behind queue and starts its writer thread.
+      /*!
+        \param connection The open connection to write with, it is used
+               exclusively by the writer thread.
+        \param row The type of row to write.
+        \param table The name of the table to write to.
+        \param mode The statement to write rows with.
+        \param capacity The number of rows the queue holds, rounded up to a
+               power of two.
+        \param flush_size The number of queued rows that triggers a flush.
+        \param flush_interval The longest a row waits before being flushed.
+      */
+      WriteBehind(Connection connection, Row row, std::string table,
+        WriteMode mode, std::size_t capacity = DEFAULT_CAPACITY,
+        std::size_t flush_size = DEFAULT_FLUSH_SIZE,
+        std::chrono::milliseconds flush_interval = DEFAULT_FLUSH_INTERVAL);
+
+      //! Writes all queued rows and stops the writer thread.
+      ~WriteBehind();
+
+      //! Queues a row without waiting.
+      /*!
+        \param value The row to write.
+        \return <code>true</code> iff the row was queued, otherwise the queue
+                is full and the row is discarded.
+      */
+      bool try_push(Type value);
+
+      //! Queues a row, waiting for room if the queue is full.
+      /*!
+        \param value The row to write.
+      */
+      void push(Type value);
+
+      //! Waits until every row queued before this call is written, rethrowing
+      //! the first error the writer thread encountered since the last flush.
+      void flush();
+
+      //! Returns the queue's counters.
+      Statistics get_statistics() const;
+
+    private:
+      Connection m_connection;
+      Row m_row;
+      std::string m_table;
+      WriteMode m_mode;
+      std::size_t m_flush_size;
+      std::chrono::milliseconds m_flush_interval;
+      std::vector<int> m_key_columns;
+      RawColumn m_key_column;
+      std::string m_key_buffer;
+      Details::MpscQueue<Type> m_queue;
+      std::atomic<std::uint64_t> m_enqueued;
+      std::atomic<std::uint64_t> m_dequeued;
+      std::atomic<std::uint64_t> m_written;
+      std::atomic<std::uint64_t> m_coalesced;
+      std::atomic<std::uint64_t> m_flushes;
+      std::atomic<std::uint64_t> m_rejected;
+      std::atomic<std::uint64_t> m_stalls;
+      std::atomic<std::int64_t> m_last_flush_latency;
+      std::atomic<std::int64_t> m_max_flush_latency;
+      mutable std::mutex m_mutex;
+      std::condition_variable m_wake_condition;
+      std::condition_variable m_flushed_condition;
+      std::uint64_t m_completed;
+      std::uint64_t m_flush_target;
+      bool m_is_stopping;
+      std::exception_ptr m_error;
+      std::thread m_writer;
+
+      WriteBehind(const WriteBehind&) = delete;
+      WriteBehind& operator =(const WriteBehind&) = delete;
+      bool enqueue(Type& value);
+      std::size_t get_depth() const;
+      void run();
+      std::size_t drain(std::vector<Type>& batch,
+        std::unordered_map<std::string, std::size_t>& keys,
+        std::string& key);
+      void write(std::vector<Type>& batch);
+      void append_key(const Type& value, std::string& key);
+  };
+
+  template<typename C, typename R>
+  WriteBehind<C, R>::WriteBehind(Connection connection, Row row,
+      std::string table, WriteMode mode, std::size_t capacity,
+      std::size_t flush_size, std::chrono::milliseconds flush_interval)
+      : m_connection(std::move(connection)),
+        m_row(std::move(row)),
+        m_table(std::move(table)),
+        m_mode(mode),
+        m_flush_size(std::max<std::size_t>(1, flush_size)),
+        m_flush_interval(flush_interval),
+        m_key_column(),
+        m_queue(capacity),
+        m_enqueued(0),
+        m_dequeued(0),
+        m_written(0),
+        m_coalesced(0),
+        m_flushes(0),
+        m_rejected(0),
+        m_stalls(0),
+        m_last_flush_latency(0),
+        m_max_flush_latency(0),
+        m_completed(0),
+        m_flush_target(0),
+        m_is_stopping(false) {
+    if(m_mode == WriteMode::UPSERT) {
+      for(auto& index : m_row.get_indexes()) {
+        if(!index.m_is_primary) {
+          continue;
+        }
+        auto& columns = m_row.get_columns();
+        for(auto& name : index.m_columns) {
+          auto column = std::find_if(columns.begin(), columns.end(),
+            [&] (const auto& column) {
+              return column.m_name == name;
+            });
+          if(column != columns.end()) {
+            m_key_columns.push_back(
+              static_cast<int>(column - columns.begin()));
+          }
+        }
+      }
+    }
+    m_writer = std::thread([this] {
+      run();
+    });
+  }
+
+  template<typename C, typename R>
+  WriteBehind<C, R>::~WriteBehind() {
+    {
+      auto lock = std::lock_guard(m_mutex);
+      m_is_stopping = true;
+    }
+    m_wake_condition.notify_one();
+    m_writer.join();
+  }
+
+  template<typename C, typename R>
+  bool WriteBehind<C, R>::try_push(Type value) {
+    if(!enqueue(value)) {
+      m_rejected.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  template<typename C, typename R>
+  void WriteBehind<C, R>::push(Type value) {
+    if(enqueue(value)) {
+      return;
+    }
+    m_stalls.fetch_add(1, std::memory_order_relaxed);
+    m_wake_condition.notify_one();
+    while(!enqueue(value)) {
+      std::this_thread::yield();
+    }
+  }
+
+  template<typename C, typename R>
+  void WriteBehind<C, R>::flush() {
+    auto lock = std::unique_lock(m_mutex);
+    auto target = m_enqueued.load(std::memory_order_acquire);
+    m_flush_target = std::max(m_flush_target, target);
+    m_wake_condition.notify_one();
+    m_flushed_condition.wait(lock, [&] {
+      return m_completed >= target;
+    });
+    if(m_error) {
+      auto error = std::exchange(m_error, nullptr);
+      std::rethrow_exception(error);
+    }
+  }
+
+  template<typename C, typename R>
+  typename WriteBehind<C, R>::Statistics
+      WriteBehind<C, R>::get_statistics() const {
+    auto statistics = Statistics();
+    statistics.m_depth = get_depth();
+    statistics.m_enqueued = m_enqueued.load(std::memory_order_relaxed);
+    statistics.m_written = m_written.load(std::memory_order_relaxed);
+    statistics.m_coalesced = m_coalesced.load(std::memory_order_relaxed);
+    statistics.m_flushes = m_flushes.load(std::memory_order_relaxed);
+    statistics.m_rejected = m_rejected.load(std::memory_order_relaxed);
+    statistics.m_stalls = m_stalls.load(std::memory_order_relaxed);
+    statistics.m_last_flush_latency = std::chrono::nanoseconds(
+      m_last_flush_latency.load(std::memory_order_relaxed));
+    statistics.m_max_flush_latency = std::chrono::nanoseconds(
+      m_max_flush_latency.load(std::memory_order_relaxed));
+    return statistics;
+  }
+
+  template<typename C, typename R>
+  bool WriteBehind<C, R>::enqueue(Type& value) {
+    if(!m_queue.try_push(value)) {
+      return false;
+    }
+    m_enqueued.fetch_add(1, std::memory_order_release);
+    if(get_depth() == m_flush_size) {
+      m_wake_condition.notify_one();
+    }
+    return true;
+  }
+
+  template<typename C, typename R>
+  std::size_t WriteBehind<C, R>::get_depth() const {
+    auto dequeued = m_dequeued.load(std::memory_order_relaxed);
+    auto enqueued = m_enqueued.load(std::memory_order_acquire);
+    return static_cast<std::size_t>(enqueued - std::min(enqueued, dequeued));
+  }
+
+  template<typename C, typename R>
+  void WriteBehind<C, R>::run() {
+    auto batch = std::vector<Type>();
+    auto keys = std::unordered_map<std::string, std::size_t>();
+    auto key = std::string();
+    while(true) {
+      auto is_stopping = false;
+      {
+        auto lock = std::unique_lock(m_mutex);
+        m_wake_condition.wait_for(lock, m_flush_interval, [&] {
+          return m_is_stopping || m_flush_target > m_completed ||
+            get_depth() >= m_flush_size;
+        });
+        is_stopping = m_is_stopping;
+      }
+      auto count = drain(batch, keys, key);
+      if(count != 0) {
+        try {
+          write(batch);
+        } catch(...) {
+          auto lock = std::lock_guard(m_mutex);
+          if(!m_error) {
+            m_error = std::current_exception();
+          }
+        }
+      }
+      {
+        auto lock = std::lock_guard(m_mutex);
+        m_completed += count;
+      }
+      m_flushed_condition.notify_all();
+      if(is_stopping && count == 0 && get_depth() == 0) {
+        return;
+      }
+    }
+  }
+
+  template<typename C, typename R>
+  std::size_t WriteBehind<C, R>::drain(std::vector<Type>& batch,
+      std::unordered_map<std::string, std::size_t>& keys, std::string& key) {
+    batch.clear();
+    keys.clear();
+    auto count = std::size_t(0);
+    auto value = Type();
+    while(count != m_flush_size && m_queue.try_pop(value)) {
+      ++count;
+      if(m_key_columns.empty()) {
+        batch.push_back(std::move(value));
+        continue;
+      }
+      key.clear();
+      append_key(value, key);
+      auto entry = keys.find(key);
+      if(entry == keys.end()) {
+        keys.emplace(key, batch.size());
+        batch.push_back(std::move(value));
+      } else {
+        batch[entry->second] = std::move(value);
+        m_coalesced.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    m_dequeued.fetch_add(count, std::memory_order_relaxed);
+    return count;
+  }
+
+  template<typename C, typename R>
+  void WriteBehind<C, R>::write(std::vector<Type>& batch) {
+    auto start = std::chrono::steady_clock::now();
+    if(m_mode == WriteMode::UPSERT) {
+      m_connection.execute(upsert(m_row, m_table, batch.begin(),
+        batch.end()));
+    } else {
+      m_connection.execute(insert(m_row, m_table, batch.begin(),
+        batch.end()));
+    }
+    auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count();
+    m_written.fetch_add(batch.size(), std::memory_order_relaxed);
+    m_flushes.fetch_add(1, std::memory_order_relaxed);
+    m_last_flush_latency.store(latency, std::memory_order_relaxed);
+    if(latency > m_max_flush_latency.load(std::memory_order_relaxed)) {
+      m_max_flush_latency.store(latency, std::memory_order_relaxed);
+    }
+  }
+
+  template<typename C, typename R>
+  void WriteBehind<C, R>::append_key(const Type& value, std::string& key) {
+    auto& column = m_key_column;
+    for(auto index : m_key_columns) {
+      m_row.store_value(value, index, column, m_key_buffer);
+      key += static_cast<char>(column.m_type);
+      if(column.m_type == RawColumn::Type::TEXT ||
+          column.m_type == RawColumn::Type::BLOB) {
+        auto size = column.m_size;
+        key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        key.append(column.m_data, column.m_size);
+      } else if(column.m_type == RawColumn::Type::REAL) {
+        key.append(reinterpret_cast<const char*>(&column.m_real),
+          sizeof(column.m_real));
+      } else {
+        key.append(reinterpret_cast<const char*>(&column.m_integer),
+          sizeof(column.m_integer));
+      }
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <catch.hpp>
+#include "Viper/ConnectionPool.hpp"
+
+using namespace Viper;
+
+namespace {
+  struct Counters {
+    std::atomic_int m_opens = 0;
+    std::atomic_int m_closes = 0;
+    std::atomic_int m_pings = 0;
+    std::atomic_int m_resets = 0;
+    std::atomic_bool m_is_alive = true;
+    std::atomic_int m_active = 0;
+    std::atomic_int m_peak_active = 0;
+  };
+
+  struct TestConnection {
+    Counters* m_counters;
+
+    void open() {
+      ++m_counters->m_opens;
+    }
+
+    void close() {
+      ++m_counters->m_closes;
+    }
+
+    bool ping() {
+      ++m_counters->m_pings;
+      return m_counters->m_is_alive;
+    }
+
+    void reset() {
+      ++m_counters->m_resets;
+    }
+  };
+}
+
+TEST_CASE("test_connection_pool_reuse", "[connection_pool]") {
+  auto counters = Counters();
+  auto pool = ConnectionPool<TestConnection>(2, [&] {
+    return TestConnection{&counters};
+  });
+  {
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    REQUIRE(pool.get_statistics().m_in_use == 2);
+  }
+  {
+    auto a = pool.acquire();
+  }
+  auto statistics = pool.get_statistics();
+  REQUIRE(counters.m_opens == 2);
+  REQUIRE(counters.m_resets == 3);
+  REQUIRE(counters.m_pings == 0);
+  REQUIRE(statistics.m_size == 2);
+  REQUIRE(statistics.m_in_use == 0);
+  REQUIRE(statistics.m_peak_in_use == 2);
+  REQUIRE(statistics.m_checkouts == 3);
+  REQUIRE(statistics.m_opens == 2);
+  REQUIRE(statistics.m_waits == 0);
+}
+
+TEST_CASE("test_connection_pool_health", "[connection_pool]") {
+  auto counters = Counters();
+  auto pool = ConnectionPool<TestConnection>(1, [&] {
+    return TestConnection{&counters};
+  }, std::chrono::hours(1), std::chrono::milliseconds(0));
+  {
+    auto a = pool.acquire();
+  }
+  counters.m_is_alive = false;
+  {
+    auto a = pool.acquire();
+  }
+  REQUIRE(counters.m_pings == 1);
+  REQUIRE(counters.m_opens == 2);
+  REQUIRE(counters.m_closes == 1);
+  REQUIRE(pool.get_statistics().m_failures == 1);
+  REQUIRE(pool.get_statistics().m_size == 1);
+}
+
+TEST_CASE("test_connection_pool_eviction", "[connection_pool]") {
+  auto counters = Counters();
+  auto pool = ConnectionPool<TestConnection>(2, [&] {
+    return TestConnection{&counters};
+  }, std::chrono::milliseconds(0));
+  {
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+  }
+  {
+    auto a = pool.acquire();
+  }
+  REQUIRE(counters.m_closes == 2);
+  REQUIRE(pool.get_statistics().m_evictions == 2);
+  REQUIRE(pool.get_statistics().m_opens == 3);
+}
+
+TEST_CASE("test_connection_pool_bounded", "[connection_pool]") {
+  auto counters = Counters();
+  auto pool = ConnectionPool<TestConnection>(3, [&] {
+    return TestConnection{&counters};
+  });
+  auto threads = std::vector<std::thread>();
+  for(auto i = 0; i != 8; ++i) {
+    threads.emplace_back([&] {
+      for(auto j = 0; j != 200; ++j) {
+        auto connection = pool.acquire();
+        auto active = ++counters.m_active;
+        auto peak = counters.m_peak_active.load();
+        while(active > peak &&
+          !counters.m_peak_active.compare_exchange_weak(peak, active)) {}
+        std::this_thread::yield();
+        --counters.m_active;
+      }
+    });
+  }
+  for(auto& thread : threads) {
+    thread.join();
+  }
+  auto statistics = pool.get_statistics();
+  REQUIRE(counters.m_peak_active <= 3);
+  REQUIRE(counters.m_opens <= 3);
+  REQUIRE(statistics.m_peak_in_use <= 3);
+  REQUIRE(statistics.m_checkouts == 1600);
+  REQUIRE(statistics.m_in_use == 0);
+  auto histogram_total = std::uint64_t(0);
+  for(auto count : statistics.m_wait_histogram) {
+    histogram_total += count;
+  }
+  REQUIRE(histogram_total == 1600);
+}
+
+TEST_CASE("test_connection_pool_open_failure", "[connection_pool]") {
+  auto pool = ConnectionPool<TestConnection>(1, [] () -> TestConnection {
+    throw std::runtime_error("unavailable");
+  });
+  REQUIRE_THROWS(pool.acquire());
+  REQUIRE(pool.get_statistics().m_size == 0);
+  REQUIRE(pool.get_statistics().m_in_use == 0);
+}
@@ -0,0 +1,60 @@
+#include <catch.hpp>
+#include "Viper/Conversions.hpp"
+
+using namespace Viper;
+
+namespace {
+  RawColumn make_text(const std::string& text) {
+    auto column = RawColumn();
+    column.m_data = text.data();
+    column.m_size = text.size();
+    return column;
+  }
+}
+
+TEST_CASE("test_double_round_trip", "[conversions]") {
+  for(auto value : {0.1, 1.0 / 3.0, 123456.789, -2.5e-300, 1e300}) {
+    auto text = std::string();
+    to_sql(value, text);
+    REQUIRE(from_sql<double>(make_text(text)) == value);
+  }
+  auto text = std::string();
+  to_sql(0.1, text);
+  REQUIRE(text == "0.1");
+}
+
+TEST_CASE("test_integer_conversions", "[conversions]") {
+  auto text = std::string();
+  to_sql(std::int64_t(-9000000000), text);
+  REQUIRE(text == "-9000000000");
+  REQUIRE(from_sql<std::int64_t>(make_text(text)) == -9000000000);
+  auto truncated = std::string("12345");
+  auto column = make_text(truncated);
+  column.m_size = 3;
+  REQUIRE(from_sql<int>(column) == 123);
+  REQUIRE_THROWS_AS(from_sql<int>(make_text("abc")), std::invalid_argument);
+  REQUIRE(from_sql<int>(make_text(" \t42")) == 42);
+  REQUIRE(from_sql<int>(make_text("+42")) == 42);
+  REQUIRE(from_sql<double>(make_text("+2.5")) == 2.5);
+  REQUIRE_THROWS_AS(from_sql<int>(make_text("42abc")), std::invalid_argument);
+  REQUIRE_THROWS_AS(from_sql<int>(make_text("42 ")), std::invalid_argument);
+  REQUIRE_THROWS_AS(from_sql<int>(make_text("+-42")), std::invalid_argument);
+  REQUIRE_THROWS_AS(from_sql<int>(make_text("")), std::invalid_argument);
+  REQUIRE_THROWS_AS(from_sql<std::int16_t>(make_text("70000")),
+    std::out_of_range);
+}
+
+TEST_CASE("test_date_time_parsing", "[conversions]") {
+  REQUIRE(from_sql<DateTime>(make_text("2021-03-04 05:06:07")) ==
+    DateTime(2021, 3, 4, 5, 6, 7, 0));
+  REQUIRE(from_sql<DateTime>(make_text("2021-03-04 05:06:07.25")) ==
+    DateTime(2021, 3, 4, 5, 6, 7, 25));
+  REQUIRE(from_sql<DateTime>(make_text("2021-03-04 05:06:07.123456")) ==
+    DateTime(2021, 3, 4, 5, 6, 7, 123));
+  auto value = DateTime(1999, 12, 31, 23, 59, 59, 999);
+  auto text = to_string(value);
+  REQUIRE(from_sql<DateTime>(make_text(text.substr(1, text.size() - 2))) ==
+    value);
+  REQUIRE_THROWS_AS(from_sql<DateTime>(make_text("2021-03-04")),
+    std::invalid_argument);
+}
@@ -0,0 +1,86 @@
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <catch.hpp>
+#include "Viper/DataTypes/DateTimeDataType.hpp"
+
+using namespace Viper;
+
+namespace {
+  void libc_gmtime(std::time_t time, std::tm& result) {
+#ifdef _MSC_VER
+    ::gmtime_s(&result, &time);
+#else
+    ::gmtime_r(&time, &result);
+#endif
+  }
+
+  std::time_t libc_timegm(std::tm& time) {
+#ifdef _MSC_VER
+    return ::_mkgmtime(&time);
+#else
+    return ::timegm(&time);
+#endif
+  }
+
+  std::string libc_to_string(DateTime date_time) {
+    auto buffer = std::string(21, '\0');
+    buffer[0] = '\'';
+    auto delta = std::time_t(
+      date_time.get_ticks() / DateTime::TICKS_PER_SECOND);
+    auto tm = std::tm();
+    libc_gmtime(delta, tm);
+    std::strftime(&buffer[1], 20, "%Y-%m-%d %H:%M:%S", &tm);
+    buffer.pop_back();
+    auto fraction = date_time.get_ticks() % DateTime::TICKS_PER_SECOND;
+    if(fraction != 0) {
+      char digits[5];
+      std::snprintf(digits, sizeof(digits), ".%03d",
+        static_cast<int>(fraction));
+      buffer += digits;
+    }
+    buffer += '\'';
+    return buffer;
+  }
+
+  DateTime libc_date_time(int year, int month, int day, int hour, int minute,
+      int second, int milliseconds) {
+    auto tm = std::tm();
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    return DateTime(DateTime::TICKS_PER_SECOND *
+      static_cast<std::uint64_t>(libc_timegm(tm)) + milliseconds);
+  }
+}
+
+TEST_CASE("test_date_time_matches_libc", "[date_time]") {
+  auto ticks = std::uint64_t(0);
+  while(ticks < 4102444800000) {
+    auto value = DateTime(ticks);
+    REQUIRE(to_string(value) == libc_to_string(value));
+    auto delta = std::time_t(ticks / DateTime::TICKS_PER_SECOND);
+    auto expected = std::tm();
+    libc_gmtime(delta, expected);
+    auto tm = to_tm(value);
+    REQUIRE(tm.tm_year == expected.tm_year);
+    REQUIRE(tm.tm_mon == expected.tm_mon);
+    REQUIRE(tm.tm_mday == expected.tm_mday);
+    REQUIRE(tm.tm_hour == expected.tm_hour);
+    REQUIRE(tm.tm_min == expected.tm_min);
+    REQUIRE(tm.tm_sec == expected.tm_sec);
+    REQUIRE(tm.tm_wday == expected.tm_wday);
+    REQUIRE(tm.tm_yday == expected.tm_yday);
+    REQUIRE(DateTime(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+      tm.tm_hour, tm.tm_min, tm.tm_sec, static_cast<int>(
+      ticks % DateTime::TICKS_PER_SECOND)) == value);
+    ticks += 7777777777;
+  }
+  REQUIRE(DateTime(2000, 2, 29, 12, 30, 15, 5) ==
+    libc_date_time(2000, 2, 29, 12, 30, 15, 5));
+  REQUIRE(to_string(DateTime(2000, 2, 29, 12, 30, 15, 5)) ==
+    "'2000-02-29 12:30:15.005'");
+}
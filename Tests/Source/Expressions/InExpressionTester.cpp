@@ -0,0 +1,39 @@
+#include <catch.hpp>
+#include <string>
+#include <vector>
+#include "Viper/Viper.hpp"
+
+using namespace Viper;
+
+TEST_CASE("test_in_expression", "[InExpression]") {
+  auto query = std::string();
+  in(sym("id"), {1, 2, 3}).append_query(query);
+  REQUIRE(query == "(id IN (1,2,3))");
+  query.clear();
+  in(sym("name"), std::vector<std::string>{"a", "b"}).append_query(query);
+  REQUIRE(query == R"((name IN ("a","b")))");
+  query.clear();
+  in(sym("id"), std::vector<int>()).append_query(query);
+  REQUIRE(query == "(1 = 0)");
+}
+
+TEST_CASE("test_in_expression_key_set_scope", "[InExpression]") {
+  auto expression = in(sym("id"), {1, 2}) &&
+    in(sym("name"), std::vector<std::string>{"x", "y", "z"});
+  auto query = std::string();
+  {
+    auto scope = KeySetScope(3);
+    expression.append_query(query);
+    REQUIRE(query == R"(((id IN (1,2)) AND (name IN ("x","y","z"))))");
+    REQUIRE(scope.get_key_sets().size() == 1);
+    auto& keys = *scope.get_key_sets().front();
+    REQUIRE(keys.size() == 3);
+    REQUIRE(std::string(keys[2].m_data, keys[2].m_size) == "z");
+    scope.set_subqueries({"SELECT value FROM keys"});
+    query.clear();
+    expression.append_query(query);
+    REQUIRE(query ==
+      "((id IN (1,2)) AND (name IN (SELECT value FROM keys)))");
+  }
+  REQUIRE(KeySetScope::get_scope() == nullptr);
+}
@@ -0,0 +1,62 @@
+#include <catch.hpp>
+#include "Viper/Viper.hpp"
+
+using namespace Viper;
+
+TEST_CASE("test_junction_flattening", "[JunctionOperator]") {
+  auto e = sym("a") == 1 || sym("b") == 2 || sym("c") == 3;
+  auto query = std::string();
+  e.append_query(query);
+  REQUIRE(query == "((a = 1) OR (b = 2) OR (c = 3))");
+  auto junction = std::dynamic_pointer_cast<JunctionOperator>(
+    e.get_virtual_expression());
+  REQUIRE(junction != nullptr);
+  REQUIRE(junction->get_operands().size() == 3);
+  query.clear();
+  (sym("x") && (sym("y") || sym("z")) && sym("w")).append_query(query);
+  REQUIRE(query == "(x AND (y OR z) AND w)");
+}
+
+TEST_CASE("test_junction_sharing", "[JunctionOperator]") {
+  auto base = sym("a") || sym("b");
+  auto extended = base || sym("c");
+  auto query = std::string();
+  base.append_query(query);
+  REQUIRE(query == "(a OR b)");
+  query.clear();
+  extended.append_query(query);
+  REQUIRE(query == "(a OR b OR c)");
+  query.clear();
+  (sym("d") || base).append_query(query);
+  REQUIRE(query == "(d OR a OR b)");
+}
+
+TEST_CASE("test_junction_large", "[JunctionOperator]") {
+  auto e = Expression();
+  for(auto i = 0; i != 10000; ++i) {
+    auto term = sym("account") == i;
+    if(i == 0) {
+      e = std::move(term);
+    } else {
+      e = std::move(e) || std::move(term);
+    }
+  }
+  auto junction = std::dynamic_pointer_cast<JunctionOperator>(
+    e.get_virtual_expression());
+  REQUIRE(junction->get_operands().size() == 10000);
+  auto nested = sym("t0");
+  for(auto i = 1; i != 100000; ++i) {
+    if(i % 2 == 0) {
+      nested = std::move(nested) || sym("t" + std::to_string(i));
+    } else {
+      nested = std::move(nested) && sym("t" + std::to_string(i));
+    }
+  }
+  auto query = std::string();
+  e.append_query(query);
+  REQUIRE(query.starts_with("((account = 0) OR (account = 1) OR "));
+  REQUIRE(query.ends_with(" OR (account = 9999))"));
+  query.clear();
+  nested.append_query(query);
+  REQUIRE(query.ends_with(" AND t99999)"));
+}
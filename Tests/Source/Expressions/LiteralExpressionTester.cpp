@@ -21,7 +21,7 @@ TEST_CASE("test_double_literal_expression", "[literal_expression]") {
   auto l = literal(1.5);
   auto query = std::string();
   l.append_query(query);
-  REQUIRE(query == "1.500000");
+  REQUIRE(query == "1.5");
 }
 
 TEST_CASE("test_string_literal_expression", "[literal_expression]") {
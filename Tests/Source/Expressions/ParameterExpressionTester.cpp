@@ -0,0 +1,18 @@
+#include <catch.hpp>
+#include "Viper/Viper.hpp"
+
+using namespace Viper;
+
+TEST_CASE("test_parameter_expression", "[parameter_expression]") {
+  ParameterExpression p;
+  std::string query;
+  p.append_query(query);
+  REQUIRE(query == "?");
+}
+
+TEST_CASE("test_param", "[parameter_expression]") {
+  auto p = sym("x") == param() && sym("y") < param();
+  std::string query;
+  p.append_query(query);
+  REQUIRE(query == "((x = ?) AND (y < ?))");
+}
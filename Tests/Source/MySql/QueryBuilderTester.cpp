@@ -24,6 +24,45 @@ TEST_CASE("test_build_upsert_query", "[mysql_query_builder]") {
   std::string q;
   build_query(s, q);
   REQUIRE(q == "INSERT INTO t1 (x,y) "
-               "VALUES (123,3.140000) "
+               "VALUES (123,3.14) "
                "ON DUPLICATE KEY UPDATE y = VALUES(y);");
 }
+
+TEST_CASE("test_build_prepared_upsert_query", "[mysql_query_builder]") {
+  auto row = TableRow{123, 3.14};
+  auto s = upsert(get_row(), "t1", &row);
+  std::string q;
+  build_prepared_query(s, 2, q);
+  REQUIRE(q == "INSERT INTO t1 (x,y) "
+               "VALUES (?,?),(?,?) "
+               "ON DUPLICATE KEY UPDATE y = VALUES(y);");
+}
+
+TEST_CASE("test_build_bulk_load_query", "[mysql_query_builder]") {
+  std::string q;
+  build_bulk_load_query(get_row(), "t1", q);
+  REQUIRE(q == "LOAD DATA LOCAL INFILE 'viper' INTO TABLE t1 "
+               "CHARACTER SET binary FIELDS TERMINATED BY '\\t' "
+               "ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' (x,y);");
+}
+
+TEST_CASE("test_append_tab_separated", "[mysql_query_builder]") {
+  auto stream = std::string();
+  auto column = RawColumn();
+  auto buffer = std::string();
+  to_raw_column(std::string("a\tb\\c\nd\0e", 9), column, buffer);
+  append_tab_separated(column, stream);
+  REQUIRE(stream == "a\\tb\\\\c\\nd\\0e");
+  stream.clear();
+  to_raw_column(std::optional<int>(), column, buffer);
+  append_tab_separated(column, stream);
+  REQUIRE(stream == "\\N");
+  stream.clear();
+  to_raw_column(-42, column, buffer);
+  append_tab_separated(column, stream);
+  to_raw_column(0.1, column, buffer);
+  append_tab_separated(column, stream);
+  to_raw_column(DateTime(2020, 2, 29, 23, 59, 58, 123), column, buffer);
+  append_tab_separated(column, stream);
+  REQUIRE(stream == "-420.12020-02-29 23:59:58.123");
+}
@@ -30,8 +30,11 @@ TEST_CASE("test_extending_row", "[row_tester]") {
   auto value = Entry();
   std::array<RawColumn, 3> row_values;
   row_values[0].m_data = "123";
+  row_values[0].m_size = 3;
   row_values[1].m_data = "456";
+  row_values[1].m_size = 3;
   row_values[2].m_data = "789";
+  row_values[2].m_size = 3;
   r2.extract(row_values.data(), value);
   REQUIRE(value.a == 123);
   REQUIRE(value.b.x == 456);
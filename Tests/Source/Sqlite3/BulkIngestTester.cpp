@@ -0,0 +1,70 @@
+#include <filesystem>
+#include <catch.hpp>
+#include "Viper/Sqlite3/Sqlite3.hpp"
+
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  struct Security {
+    int m_id;
+    std::string m_symbol;
+  };
+
+  auto get_row() {
+    return Row<Security>().
+      add_column("id", &Security::m_id).
+      set_primary_key("id").
+      add_column("symbol", &Security::m_symbol).
+      add_index("symbol_index", "symbol");
+  }
+
+  template<typename T>
+  T get_pragma(Connection& c, const std::string& name) {
+    auto value = T();
+    c.execute(select(Row<T>(name), "pragma_" + name, &value));
+    return value;
+  }
+
+  bool has_index(Connection& c, const std::string& name) {
+    auto count = 0;
+    c.execute(select(Row<int>("COUNT(*)"), "sqlite_master",
+      sym("type") == "index" && sym("name") == name, &count));
+    return count != 0;
+  }
+}
+
+TEST_CASE("test_bulk_ingest", "[sqlite3_bulk_ingest]") {
+  auto path = (std::filesystem::temp_directory_path() /
+    "viper_bulk_ingest.db").string();
+  std::filesystem::remove(path);
+  {
+    auto c = Connection(path);
+    c.open();
+    c.execute(create(get_row(), "securities"));
+    REQUIRE(has_index(c, "securities_symbol_index"));
+    auto journal_mode = get_pragma<std::string>(c, "journal_mode");
+    auto synchronous = get_pragma<int>(c, "synchronous");
+    {
+      auto ingest = BulkIngest(c, get_row(), "securities");
+      REQUIRE(get_pragma<std::string>(c, "journal_mode") == "off");
+      REQUIRE(get_pragma<int>(c, "synchronous") == 0);
+      REQUIRE(get_pragma<int>(c, "temp_store") == 2);
+      REQUIRE(get_pragma<std::string>(c, "locking_mode") == "exclusive");
+      REQUIRE(!has_index(c, "securities_symbol_index"));
+      auto securities = std::vector<Security>();
+      for(auto i = 0; i != 1000; ++i) {
+        securities.push_back(Security{i, "S" + std::to_string(i)});
+      }
+      c.execute(insert(get_row(), "securities", securities));
+    }
+    REQUIRE(get_pragma<std::string>(c, "journal_mode") == journal_mode);
+    REQUIRE(get_pragma<int>(c, "synchronous") == synchronous);
+    REQUIRE(get_pragma<std::string>(c, "locking_mode") == "normal");
+    REQUIRE(has_index(c, "securities_symbol_index"));
+    auto count = 0;
+    c.execute(select(Row<int>("COUNT(*)"), "securities", &count));
+    REQUIRE(count == 1000);
+  }
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,138 @@
+#include <catch.hpp>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Viper/Sqlite3/Sqlite3.hpp"
+
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  struct Instrument {
+    int m_id;
+    std::string m_symbol;
+  };
+
+  auto get_instrument_row() {
+    return Row<Instrument>().
+      add_column("id", &Instrument::m_id).
+      set_primary_key("id").
+      add_column("symbol", &Instrument::m_symbol);
+  }
+
+  auto make_cache(std::size_t capacity) {
+    auto cache = CachedConnection(Connection(":memory:"), capacity);
+    cache.open();
+    cache.execute(create(get_instrument_row(), "instruments"));
+    cache.execute(create(get_instrument_row(), "venues"));
+    auto values = std::vector<Instrument>{{1, "ABC"}, {2, "DEF"}, {3, "GHI"}};
+    cache.execute(insert(get_instrument_row(), "instruments", values.begin(),
+      values.end()));
+    cache.execute(insert(get_instrument_row(), "venues", values.begin(),
+      values.end()));
+    return cache;
+  }
+}
+
+TEST_CASE("test_cached_select", "[CachedConnection]") {
+  auto cache = make_cache(CachedConnection<Connection>::DEFAULT_CAPACITY);
+  auto select_all = [&] (const std::string& table) {
+    auto rows = std::vector<Instrument>();
+    cache.execute(select(get_instrument_row(), table,
+      std::back_inserter(rows)));
+    return rows;
+  };
+  REQUIRE(select_all("instruments").size() == 3);
+  REQUIRE(select_all("instruments").size() == 3);
+  REQUIRE(select_all("venues").size() == 3);
+  REQUIRE(cache.get_statistics().m_hits == 1);
+  REQUIRE(cache.get_statistics().m_misses == 2);
+  REQUIRE(cache.get_statistics().m_entries == 2);
+  SECTION("Writes invalidate their table.") {
+    cache.execute(erase("instruments", sym("id") == 1));
+    REQUIRE(cache.get_statistics().m_invalidations == 1);
+    REQUIRE(select_all("instruments").size() == 2);
+    REQUIRE(select_all("venues").size() == 3);
+    REQUIRE(cache.get_statistics().m_hits == 2);
+    REQUIRE(cache.get_hit_ratio() == 2.0 / 5);
+  }
+  SECTION("Writes on the wrapped connection are observed once expired.") {
+    cache.set_time_to_live(std::chrono::milliseconds(20));
+    cache.clear();
+    REQUIRE(select_all("instruments").size() == 3);
+    cache.get_connection().execute(erase("instruments", sym("id") == 1));
+    REQUIRE(select_all("instruments").size() == 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    REQUIRE(select_all("instruments").size() == 2);
+    REQUIRE(cache.get_statistics().m_expirations == 1);
+  }
+}
+
+TEST_CASE("test_cached_select_capacity", "[CachedConnection]") {
+  auto cache = make_cache(CachedConnection<Connection>::DEFAULT_CAPACITY);
+  for(auto i = 1; i <= 3; ++i) {
+    auto row = Instrument();
+    cache.execute(select(get_instrument_row(), "instruments", sym("id") == i,
+      &row));
+  }
+  auto bytes = cache.get_statistics().m_bytes;
+  cache.set_capacity(bytes - 1);
+  REQUIRE(cache.get_statistics().m_entries == 2);
+  REQUIRE(cache.get_statistics().m_evictions == 1);
+  auto row = Instrument();
+  cache.execute(select(get_instrument_row(), "instruments", sym("id") == 3,
+    &row));
+  REQUIRE(row.m_symbol == "GHI");
+  REQUIRE(cache.get_statistics().m_hits == 1);
+  cache.execute(select(get_instrument_row(), "instruments", sym("id") == 1,
+    &row));
+  REQUIRE(row.m_symbol == "ABC");
+  REQUIRE(cache.get_statistics().m_misses == 4);
+}
+
+TEST_CASE("test_cached_select_rollback", "[CachedConnection]") {
+  auto cache = make_cache(CachedConnection<Connection>::DEFAULT_CAPACITY);
+  cache.execute(create(get_instrument_row(), "t"));
+  auto select_all = [&] {
+    auto rows = std::vector<Instrument>();
+    cache.execute(select(get_instrument_row(), "t", std::back_inserter(rows)));
+    return rows;
+  };
+  cache.execute(start_transaction());
+  auto value = Instrument{1, "ABC"};
+  cache.execute(insert(get_instrument_row(), "t", &value));
+  REQUIRE(select_all().size() == 1);
+  REQUIRE(cache.get_statistics().m_entries == 1);
+  cache.execute(rollback());
+  REQUIRE(cache.get_statistics().m_entries == 0);
+  REQUIRE(select_all().empty());
+}
+
+TEST_CASE("test_cached_subquery", "[CachedConnection]") {
+  auto cache = make_cache(CachedConnection<Connection>::DEFAULT_CAPACITY);
+  auto select_all = [&] {
+    auto rows = std::vector<Instrument>();
+    cache.execute(select(get_instrument_row(),
+      FromClause(SelectClause({"id", "symbol"}, "instruments")),
+      std::back_inserter(rows)));
+    return rows;
+  };
+  REQUIRE(select_all().size() == 3);
+  cache.execute(erase("venues", sym("id") == 1));
+  REQUIRE(cache.get_statistics().m_invalidations == 0);
+  REQUIRE(select_all().size() == 3);
+  REQUIRE(cache.get_statistics().m_hits == 1);
+  cache.execute(erase("instruments", sym("id") == 1));
+  REQUIRE(cache.get_statistics().m_invalidations == 1);
+  REQUIRE(select_all().size() == 2);
+}
+
+TEST_CASE("test_cached_select_tables", "[CachedConnection]") {
+  auto tables = std::vector<std::string>();
+  Viper::Details::append_tables(
+    "SELECT a FROM (SELECT a FROM t WHERE b = 'FROM x') AS alias WHERE a IN "
+    "(SELECT a FROM u) AND c IN (SELECT c FROM t);", tables);
+  REQUIRE(tables == std::vector<std::string>{"t", "u"});
+}
@@ -0,0 +1,102 @@
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <catch.hpp>
+#include "Viper/Sqlite3/Sqlite3.hpp"
+
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  struct Reading {
+    int m_id;
+    double m_value;
+  };
+
+  auto get_row() {
+    return Row<Reading>().
+      add_column("id", &Reading::m_id).
+      set_primary_key("id").
+      add_column("value", &Reading::m_value);
+  }
+
+  auto get_path() {
+    auto path = std::filesystem::temp_directory_path() / "viper_group.db";
+    for(auto suffix : {"", "-wal", "-shm"}) {
+      std::filesystem::remove(path.string() + suffix);
+    }
+    return path.string();
+  }
+}
+
+TEST_CASE("test_connection_group_routing", "[connection_group]") {
+  auto path = get_path();
+  {
+    auto group = ConnectionGroup(path, 2);
+    group.open();
+    group.execute(create(get_row(), "readings"));
+    auto readings = std::vector<Reading>{{1, 1.5}, {2, 2.5}};
+    group.execute(insert(get_row(), "readings", readings.begin(),
+      readings.end()));
+    auto journal_mode = group.write([] (Connection& writer) {
+      auto mode = std::string();
+      writer.execute(select(Row<std::string>("journal_mode"),
+        "pragma_journal_mode", &mode));
+      return mode;
+    });
+    REQUIRE(journal_mode == "wal");
+    auto result = std::vector<Reading>();
+    group.execute(select(get_row(), "readings", std::back_inserter(result)));
+    REQUIRE(result.size() == 2);
+    REQUIRE(group.get_reader_statistics().m_checkouts == 1);
+    REQUIRE_THROWS_AS(group.read([] (Connection& reader) {
+      reader.execute("DELETE FROM readings;");
+    }), ExecuteException);
+  }
+  get_path();
+}
+
+TEST_CASE("test_connection_group_concurrency", "[connection_group]") {
+  auto path = get_path();
+  {
+    auto group = ConnectionGroup(path, 3);
+    group.open();
+    group.execute(create(get_row(), "readings"));
+    auto writer = std::thread([&] {
+      for(auto i = 0; i != 200; ++i) {
+        auto reading = Reading{i, i * 0.5};
+        group.execute(insert(get_row(), "readings", &reading, &reading + 1));
+      }
+    });
+    auto readers = std::vector<std::thread>();
+    auto is_ordered = std::atomic_bool(true);
+    for(auto i = 0; i != 3; ++i) {
+      readers.emplace_back([&] {
+        auto last_size = std::size_t(0);
+        for(auto j = 0; j != 50; ++j) {
+          auto result = std::vector<Reading>();
+          group.execute(select(get_row(), "readings",
+            std::back_inserter(result)));
+          if(result.size() < last_size) {
+            is_ordered = false;
+          }
+          last_size = result.size();
+        }
+      });
+    }
+    writer.join();
+    for(auto& reader : readers) {
+      reader.join();
+    }
+    REQUIRE(is_ordered);
+    REQUIRE(group.get_reader_statistics().m_peak_in_use <= 3);
+    auto count = group.read([] (Connection& reader) {
+      auto result = std::vector<Reading>();
+      reader.execute(select(get_row(), "readings",
+        std::back_inserter(result)));
+      return result.size();
+    });
+    REQUIRE(count == 200);
+  }
+  get_path();
+}
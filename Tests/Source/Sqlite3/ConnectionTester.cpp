@@ -0,0 +1,613 @@
+#include <catch.hpp>
+#include <iterator>
+#include <sstream>
+#include "Viper/Sqlite3/Sqlite3.hpp"
+
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  struct TableRow {
+    int m_x;
+    double m_y;
+  };
+
+  auto get_row() {
+    return Row<TableRow>().
+      add_column("x", &TableRow::m_x).
+      set_primary_key("x").
+      add_column("y", &TableRow::m_y);
+  }
+}
+
+TEST_CASE("test_statement_cache", "[sqlite3_connection]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_row(), "t1"));
+  auto value = TableRow{1, 2.5};
+  c.execute(insert(get_row(), "t1", &value));
+  SECTION("Repeated selects reuse the compiled statement.") {
+    for(auto i = 0; i != 3; ++i) {
+      auto selected_value = TableRow();
+      c.execute(select(get_row(), "t1", sym("x") == 1, &selected_value));
+      REQUIRE(selected_value.m_y == 2.5);
+    }
+    REQUIRE(c.get_statement_cache_statistics().m_misses == 1);
+    REQUIRE(c.get_statement_cache_statistics().m_hits == 2);
+    REQUIRE(c.get_statement_cache_statistics().m_evictions == 0);
+  }
+  SECTION("Least recently used statements are evicted.") {
+    c.set_statement_cache_capacity(1);
+    auto rows = std::vector<TableRow>();
+    c.execute(select(get_row(), "t1", sym("x") == 1, std::back_inserter(rows)));
+    c.execute(select(get_row(), "t1", sym("x") == 2, std::back_inserter(rows)));
+    c.execute(select(get_row(), "t1", sym("x") == 1, std::back_inserter(rows)));
+    REQUIRE(rows.size() == 2);
+    REQUIRE(c.get_statement_cache_statistics().m_misses == 3);
+    REQUIRE(c.get_statement_cache_statistics().m_evictions == 2);
+  }
+  SECTION("Deletes run through the cache.") {
+    c.execute(erase("t1", sym("x") == 1));
+    c.execute(erase("t1", sym("x") == 1));
+    REQUIRE(c.get_statement_cache_statistics().m_hits == 1);
+    auto rows = std::vector<TableRow>();
+    c.execute(select(get_row(), "t1", std::back_inserter(rows)));
+    REQUIRE(rows.empty());
+  }
+}
+
+TEST_CASE("test_bound_insert", "[sqlite3_connection]") {
+  struct Entry {
+    std::string m_name;
+    int m_count;
+  };
+  auto row = Row<Entry>().
+    add_column("name", &Entry::m_name).
+    add_column("count", &Entry::m_count);
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(row, "t1"));
+  auto entries = std::vector<Entry>();
+  for(auto i = 0; i != 1000; ++i) {
+    entries.push_back(Entry{"it's \"" + std::to_string(i) + "\"", i});
+  }
+  c.execute(insert(row, "t1", entries.begin(), entries.end()));
+  auto selected_entries = std::vector<Entry>();
+  c.execute(select(row, "t1", std::back_inserter(selected_entries)));
+  REQUIRE(selected_entries.size() == entries.size());
+  for(auto i = std::size_t(0); i != entries.size(); ++i) {
+    REQUIRE(selected_entries[i].m_name == entries[i].m_name);
+    REQUIRE(selected_entries[i].m_count == entries[i].m_count);
+  }
+}
+
+TEST_CASE("test_prepared_select", "[sqlite3_connection]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_row(), "t1"));
+  auto values = std::vector<TableRow>();
+  for(auto i = 0; i != 10; ++i) {
+    values.push_back(TableRow{i, 1.5 * i});
+  }
+  c.execute(insert(get_row(), "t1", values.begin(), values.end()));
+  auto rows = std::vector<TableRow>();
+  auto statement = c.prepare(select(get_row(), "t1",
+    sym("x") == param(), std::back_inserter(rows)));
+  REQUIRE(statement.get_parameter_count() == 1);
+  for(auto i = 0; i != 10; ++i) {
+    statement.execute(i);
+  }
+  REQUIRE(rows.size() == 10);
+  for(auto i = 0; i != 10; ++i) {
+    REQUIRE(rows[i].m_x == i);
+    REQUIRE(rows[i].m_y == 1.5 * i);
+  }
+  REQUIRE_THROWS_AS(statement.execute(), ExecuteException);
+  REQUIRE_THROWS_AS(statement.execute(1, 2), ExecuteException);
+}
+
+TEST_CASE("test_prepared_statement", "[sqlite3_connection]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_row(), "t1"));
+  auto values = std::vector<TableRow>{{1, 1}, {2, 2}, {3, 3}};
+  c.execute(insert(get_row(), "t1", values.begin(), values.end()));
+  auto update_statement = c.prepare(update("t1",
+    {"y", param()}, sym("x") == param()));
+  update_statement.execute(10.5, 2);
+  auto erase_statement = c.prepare(erase("t1", sym("x") == param()));
+  erase_statement.execute(1);
+  erase_statement.execute(3);
+  auto rows = std::vector<TableRow>();
+  c.execute(select(get_row(), "t1", std::back_inserter(rows)));
+  REQUIRE(rows.size() == 1);
+  REQUIRE(rows[0].m_x == 2);
+  REQUIRE(rows[0].m_y == 10.5);
+}
+
+TEST_CASE("test_static_row", "[sqlite3_connection]") {
+  using StaticTableRow = StaticRow<TableRow, Field<"x", &TableRow::m_x>,
+    Field<"y", &TableRow::m_y>>;
+  auto row = StaticTableRow().set_primary_key("x");
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(row, "t1"));
+  auto values = std::vector<TableRow>{{1, 1.5}, {2, 2.5}, {3, 3.5}};
+  c.execute(insert(row, "t1", values.begin(), values.end()));
+  auto rows = std::vector<TableRow>();
+  c.execute(select(row, "t1", sym("x") >= 2, std::back_inserter(rows)));
+  REQUIRE(rows.size() == 2);
+  REQUIRE(rows[0].m_x == 2);
+  REQUIRE(rows[0].m_y == 2.5);
+  REQUIRE(rows[1].m_x == 3);
+  REQUIRE(rows[1].m_y == 3.5);
+}
+
+TEST_CASE("test_typed_fetch", "[sqlite3_connection]") {
+  struct Entry {
+    std::int64_t m_id;
+    std::uint64_t m_count;
+    double m_price;
+    std::string m_name;
+    std::vector<std::byte> m_data;
+    DateTime m_timestamp;
+  };
+  auto row = Row<Entry>().
+    add_column("id", &Entry::m_id).
+    add_column("count", &Entry::m_count).
+    add_column("price", &Entry::m_price).
+    add_column("name", &Entry::m_name).
+    add_column("data", &Entry::m_data).
+    add_column("timestamp", &Entry::m_timestamp);
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(row, "t1"));
+  auto entries = std::vector<Entry>{
+    {-9000000000, 18000000000000000000u, 0.1, "abc",
+      {std::byte(0), std::byte(1)}, DateTime(2020, 2, 29, 23, 59, 58, 123)},
+    {1, 2, 1e300, std::string("a\0b", 3), {},
+      DateTime(1999, 12, 31, 0, 0, 0, 0)}};
+  c.execute(insert(row, "t1", entries.begin(), entries.end()));
+  auto selected_entries = std::vector<Entry>();
+  c.execute(select(row, "t1", std::back_inserter(selected_entries)));
+  REQUIRE(selected_entries.size() == entries.size());
+  for(auto i = std::size_t(0); i != entries.size(); ++i) {
+    REQUIRE(selected_entries[i].m_id == entries[i].m_id);
+    REQUIRE(selected_entries[i].m_count == entries[i].m_count);
+    REQUIRE(selected_entries[i].m_price == entries[i].m_price);
+    REQUIRE(selected_entries[i].m_name == entries[i].m_name);
+    REQUIRE(selected_entries[i].m_data == entries[i].m_data);
+    REQUIRE(selected_entries[i].m_timestamp == entries[i].m_timestamp);
+  }
+  auto largest = std::optional<double>();
+  c.execute(select(max<double>("price"), "t1", sym("id") == 5, &largest));
+  REQUIRE(!largest.has_value());
+  c.execute(select(max<double>("price"), "t1", &largest));
+  REQUIRE(largest == 1e300);
+}
+
+TEST_CASE("test_fetch_plan", "[sqlite3_connection]") {
+  struct Entry {
+    int m_id;
+    float m_price;
+    std::string m_name;
+    std::vector<std::byte> m_data;
+    DateTime m_timestamp;
+  };
+  auto row = Row<Entry>().
+    add_column("id", &Entry::m_id).
+    add_column("price", &Entry::m_price).
+    add_column("name", &Entry::m_name).
+    add_column("data", &Entry::m_data).
+    add_column("timestamp", &Entry::m_timestamp);
+  auto plan = std::vector<FetchKind>();
+  build_fetch_plan(row.get_columns(), plan);
+  REQUIRE(plan == std::vector<FetchKind>{FetchKind::INTEGER, FetchKind::REAL,
+    FetchKind::TEXT, FetchKind::BLOB, FetchKind::TEXT});
+}
+
+TEST_CASE("test_nested_select", "[sqlite3_connection]") {
+  struct MaxInserter {
+    Connection* m_connection;
+    std::vector<std::pair<TableRow, double>>* m_rows;
+
+    MaxInserter& operator *() {
+      return *this;
+    }
+
+    MaxInserter& operator ++() {
+      return *this;
+    }
+
+    MaxInserter& operator =(const TableRow& row) {
+      auto largest = std::optional<double>();
+      m_connection->execute(select(max<double>("y"), "t1", &largest));
+      m_rows->emplace_back(row, *largest);
+      return *this;
+    }
+  };
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_row(), "t1"));
+  auto values = std::vector<TableRow>{{1, 1.5}, {2, 2.5}, {3, 3.5}};
+  c.execute(insert(get_row(), "t1", values.begin(), values.end()));
+  auto rows = std::vector<std::pair<TableRow, double>>();
+  c.execute(select(get_row(), "t1", MaxInserter{&c, &rows}));
+  REQUIRE(rows.size() == 3);
+  for(auto i = std::size_t(0); i != rows.size(); ++i) {
+    REQUIRE(rows[i].first.m_x == values[i].m_x);
+    REQUIRE(rows[i].first.m_y == values[i].m_y);
+    REQUIRE(rows[i].second == 3.5);
+  }
+}
+
+TEST_CASE("test_query_cursor", "[sqlite3_connection]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_row(), "t1"));
+  auto values = std::vector<TableRow>();
+  for(auto i = 0; i != 100; ++i) {
+    values.push_back(TableRow{i, 0.5 * i});
+  }
+  c.execute(insert(get_row(), "t1", values.begin(), values.end()));
+  SECTION("All rows are visited in order.") {
+    auto count = 0;
+    for(auto& value : c.query(get_row(), "t1", order_by("x", Order::ASC))) {
+      REQUIRE(value.m_x == count);
+      REQUIRE(value.m_y == 0.5 * count);
+      ++count;
+    }
+    REQUIRE(count == 100);
+  }
+  SECTION("Iteration can stop early.") {
+    {
+      auto rows = c.query(get_row(), "t1", sym("x") >= 10);
+      auto i = rows.begin();
+      REQUIRE(i->m_x == 10);
+      ++i;
+      REQUIRE(i->m_x == 11);
+    }
+    auto rows = c.query(get_row(), "t1", sym("x") >= 10);
+    auto count = std::distance(rows.begin(), rows.end());
+    REQUIRE(count == 90);
+    REQUIRE(rows.begin() == rows.end());
+  }
+  SECTION("Empty results.") {
+    auto rows = c.query(get_row(), "t1", sym("x") > 100);
+    REQUIRE(rows.begin() == rows.end());
+    REQUIRE(!rows.next());
+  }
+}
+
+TEST_CASE("test_batch_limits", "[sqlite3_connection]") {
+  struct Entry {
+    int m_id;
+    std::string m_name;
+  };
+  auto row = Row<Entry>().
+    add_column("id", &Entry::m_id).
+    set_primary_key("id").
+    add_column("name", &Entry::m_name);
+  auto c = Connection(":memory:");
+  c.open();
+  REQUIRE(c.get_batch_limits().m_max_parameters !=
+    BatchLimits().m_max_parameters);
+  c.execute(create(row, "t1"));
+  auto entries = std::vector<Entry>();
+  for(auto i = 0; i != 100; ++i) {
+    entries.push_back(Entry{i, std::string(i % 10 == 0 ? 100 : 1, 'a')});
+  }
+  SECTION("Batches are bounded by rows and parameters.") {
+    auto limits = BatchLimits();
+    limits.m_max_rows = 30;
+    limits.m_max_parameters = 40;
+    c.set_batch_limits(limits);
+    c.execute(insert(row, "t1", entries.begin(), entries.end()));
+    auto& statistics = c.get_batch_statistics();
+    REQUIRE(statistics.m_batches == 5);
+    REQUIRE(statistics.m_rows == 100);
+    REQUIRE(statistics.m_largest_batch == 20);
+    REQUIRE(statistics.m_last_batch == 20);
+  }
+  SECTION("Batches are bounded by bytes.") {
+    auto limits = BatchLimits();
+    limits.m_max_bytes = 300;
+    c.set_batch_limits(limits);
+    c.execute(insert(row, "t1", entries.begin(), entries.end()));
+    auto& statistics = c.get_batch_statistics();
+    REQUIRE(statistics.m_rows == 100);
+    REQUIRE(statistics.m_batches == 10);
+    REQUIRE(statistics.m_largest_batch == 10);
+    REQUIRE(statistics.m_bytes == 90 * 17 + 10 * 116);
+    for(auto& entry : entries) {
+      entry.m_name = "b";
+    }
+    c.execute(upsert(row, "t1", entries.begin(), entries.end()));
+    REQUIRE(statistics.m_rows == 200);
+    REQUIRE(statistics.m_batches == 16);
+    REQUIRE(statistics.m_last_batch == 15);
+  }
+  auto selected_entries = std::vector<Entry>();
+  c.execute(select(row, "t1", std::back_inserter(selected_entries)));
+  REQUIRE(selected_entries.size() == entries.size());
+  for(auto i = std::size_t(0); i != entries.size(); ++i) {
+    REQUIRE(selected_entries[i].m_id == entries[i].m_id);
+    REQUIRE(selected_entries[i].m_name == entries[i].m_name);
+  }
+}
+
+TEST_CASE("test_streaming_insert", "[sqlite3_connection]") {
+  struct Entry {
+    int m_id;
+    std::string m_name;
+  };
+  struct Entries {
+    struct Iterator {
+      using iterator_category = std::input_iterator_tag;
+      using value_type = Entry;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const Entry*;
+      using reference = const Entry&;
+
+      Entries* m_entries;
+      int m_index;
+      mutable Entry m_value;
+
+      const Entry& operator *() const {
+        ++m_entries->m_reads;
+        m_value = Entry{m_index, std::string(m_index % 10 == 0 ? 100 : 1, 'a')};
+        return m_value;
+      }
+
+      Iterator& operator ++() {
+        ++m_index;
+        return *this;
+      }
+
+      void operator ++(int) {
+        ++m_index;
+      }
+
+      bool operator ==(std::default_sentinel_t) const {
+        return m_index == m_entries->m_count;
+      }
+    };
+    int m_count;
+    int m_reads;
+
+    Iterator begin() {
+      return Iterator{this, 0, Entry()};
+    }
+
+    std::default_sentinel_t end() {
+      return {};
+    }
+  };
+  auto row = Row<Entry>().
+    add_column("id", &Entry::m_id).
+    set_primary_key("id").
+    add_column("name", &Entry::m_name);
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(row, "t1"));
+  auto limits = BatchLimits();
+  limits.m_max_bytes = 300;
+  c.set_batch_limits(limits);
+  auto entries = Entries{100, 0};
+  c.execute(insert(row, "t1", entries));
+  REQUIRE(entries.m_reads == 100);
+  REQUIRE(c.get_batch_statistics().m_batches == 10);
+  auto selected_entries = std::vector<Entry>();
+  c.execute(select(row, "t1", std::back_inserter(selected_entries)));
+  REQUIRE(selected_entries.size() == 100);
+  for(auto i = 0; i != 100; ++i) {
+    REQUIRE(selected_entries[i].m_id == i);
+    REQUIRE(selected_entries[i].m_name ==
+      std::string(i % 10 == 0 ? 100 : 1, 'a'));
+  }
+  auto values = Row<int>("value");
+  c.execute(create(values, "t2"));
+  auto stream = std::istringstream("1 2 3 4 5");
+  c.execute(insert(values, "t2", std::istream_iterator<int>(stream),
+    std::istream_iterator<int>()));
+  auto selected_values = std::vector<int>();
+  c.execute(select(values, "t2", std::back_inserter(selected_values)));
+  REQUIRE(selected_values == std::vector<int>{1, 2, 3, 4, 5});
+}
+
+TEST_CASE("test_move_only_iterator_insert", "[sqlite3_connection]") {
+  struct Entry {
+    int m_id;
+    std::string m_name;
+  };
+  struct Entries {
+    struct Iterator {
+      using value_type = Entry;
+      using difference_type = std::ptrdiff_t;
+
+      Entry m_value;
+      int m_end;
+
+      Iterator(std::string name, int end)
+        : m_value{0, std::move(name)},
+          m_end(end) {}
+
+      Iterator(Iterator&&) = default;
+
+      Iterator& operator =(Iterator&&) = default;
+
+      const Entry& operator *() const {
+        return m_value;
+      }
+
+      Iterator& operator ++() {
+        ++m_value.m_id;
+        return *this;
+      }
+
+      void operator ++(int) {
+        ++m_value.m_id;
+      }
+
+      bool operator ==(std::default_sentinel_t) const {
+        return m_value.m_id == m_end;
+      }
+    };
+    std::string m_name;
+    int m_count;
+
+    Iterator begin() {
+      return Iterator(m_name, m_count);
+    }
+
+    std::default_sentinel_t end() {
+      return {};
+    }
+  };
+  static_assert(!std::copy_constructible<Entries::Iterator>);
+  auto row = Row<Entry>().
+    add_column("id", &Entry::m_id).
+    set_primary_key("id").
+    add_column("name", &Entry::m_name);
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(row, "t1"));
+  auto inserted_entries = Entries{"a", 5};
+  c.execute(insert(row, "t1", inserted_entries));
+  auto upserted_entries = Entries{"b", 3};
+  c.execute(upsert(row, "t1", upserted_entries));
+  auto selected_entries = std::vector<Entry>();
+  c.execute(select(row, "t1", std::back_inserter(selected_entries)));
+  REQUIRE(selected_entries.size() == 5);
+  for(auto i = 0; i != 5; ++i) {
+    REQUIRE(selected_entries[i].m_id == i);
+    REQUIRE(selected_entries[i].m_name == (i < 3 ? "b" : "a"));
+  }
+}
+
+TEST_CASE("test_in_key_sets", "[sqlite3_connection]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_row(), "t1"));
+  auto values = std::vector<TableRow>();
+  for(auto i = 0; i != 1000; ++i) {
+    values.push_back(TableRow{i, 0.5 * i});
+  }
+  c.execute(insert(get_row(), "t1", values.begin(), values.end()));
+  auto keys = std::vector<int>();
+  for(auto i = 0; i < 1000; i += 3) {
+    keys.push_back(i);
+  }
+  SECTION("Large sets are staged in a temporary table.") {
+    auto rows = std::vector<TableRow>();
+    c.execute(select(get_row(), "t1", in(sym("x"), keys),
+      std::back_inserter(rows)));
+    REQUIRE(rows.size() == keys.size());
+    auto count = 0;
+    c.execute(select(Viper::count("*"), "temp.viper_keys_0", &count));
+    REQUIRE(count == static_cast<int>(keys.size()));
+    c.execute(erase("t1", in(sym("x"), keys) && sym("x") < 500));
+    rows.clear();
+    c.execute(select(get_row(), "t1", std::back_inserter(rows)));
+    REQUIRE(rows.size() == 1000 - 167);
+  }
+  SECTION("Small sets are rendered as literals.") {
+    c.set_key_set_threshold(keys.size() + 1);
+    auto rows = std::vector<TableRow>();
+    c.execute(select(get_row(), "t1", in(sym("x"), keys),
+      std::back_inserter(rows)));
+    REQUIRE(rows.size() == keys.size());
+    auto count = 0;
+    REQUIRE_THROWS(c.execute(
+      select(Viper::count("*"), "temp.viper_keys_0", &count)));
+  }
+  SECTION("Open cursors and prepared statements keep their key sets.") {
+    auto evens = std::vector<int>();
+    for(auto i = 0; i < 1000; i += 2) {
+      evens.push_back(i);
+    }
+    auto cursor = c.query(get_row(), "t1", in(sym("x"), keys));
+    auto prepared_rows = std::vector<TableRow>();
+    auto prepared = c.prepare(select(get_row(), "t1", in(sym("x"), evens),
+      std::back_inserter(prepared_rows)));
+    auto count = 0;
+    for(auto& value : cursor) {
+      REQUIRE(value.m_x % 3 == 0);
+      auto rows = std::vector<TableRow>();
+      c.execute(select(get_row(), "t1",
+        in(sym("x"), evens) && sym("x") == value.m_x,
+        std::back_inserter(rows)));
+      REQUIRE(rows.size() == (value.m_x % 2 == 0 ? 1 : 0));
+      ++count;
+    }
+    REQUIRE(count == static_cast<int>(keys.size()));
+    auto staged_count = 0;
+    c.execute(select(Viper::count("*"), "temp.viper_keys_2", &staged_count));
+    REQUIRE(staged_count == static_cast<int>(evens.size()));
+    prepared.execute();
+    REQUIRE(prepared_rows.size() == evens.size());
+  }
+  SECTION("Moved connections keep their key sets.") {
+    auto moved_connection = std::move(c);
+    moved_connection.set_key_set_threshold(10);
+    auto rows = std::vector<TableRow>();
+    moved_connection.execute(select(get_row(), "t1", in(sym("x"), keys),
+      std::back_inserter(rows)));
+    REQUIRE(rows.size() == keys.size());
+    auto count = 0;
+    moved_connection.execute(
+      select(Viper::count("*"), "temp.viper_keys_0", &count));
+    REQUIRE(count == static_cast<int>(keys.size()));
+  }
+}
+
+TEST_CASE("test_get_many", "[sqlite3_connection]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_row(), "t1"));
+  auto values = std::vector<TableRow>();
+  for(auto i = 0; i != 100; ++i) {
+    values.push_back(TableRow{2 * i, 0.5 * i});
+  }
+  c.execute(insert(get_row(), "t1", values.begin(), values.end()));
+  SECTION("Rows are returned in key order.") {
+    auto limits = c.get_batch_limits();
+    limits.m_max_rows = 3;
+    c.set_batch_limits(limits);
+    auto keys = std::vector<int>{10, 3, 198, 10, 7, 0, 400};
+    auto rows = std::vector<std::optional<TableRow>>();
+    c.get_many(get_row(), "t1", keys.begin(), keys.end(),
+      std::back_inserter(rows));
+    REQUIRE(rows.size() == keys.size());
+    REQUIRE(rows[0]->m_y == 2.5);
+    REQUIRE(!rows[1]);
+    REQUIRE(rows[2]->m_x == 198);
+    REQUIRE(rows[3]->m_x == 10);
+    REQUIRE(!rows[4]);
+    REQUIRE(rows[5]->m_x == 0);
+    REQUIRE(!rows[6]);
+  }
+  SECTION("Composite keys are matched as row values.") {
+    struct PairRow {
+      int m_a;
+      std::string m_b;
+      int m_c;
+    };
+    auto row = Row<PairRow>().
+      add_column("a", &PairRow::m_a).
+      add_column("b", &PairRow::m_b).
+      add_column("c", &PairRow::m_c).
+      set_primary_key({"a", "b"});
+    c.execute(create(row, "t2"));
+    auto pairs = std::vector<PairRow>{{1, "x", 10}, {1, "y", 11}, {2, "x", 12}};
+    c.execute(insert(row, "t2", pairs.begin(), pairs.end()));
+    auto keys = std::vector<std::tuple<int, std::string>>{
+      {2, "x"}, {2, "y"}, {1, "y"}};
+    auto rows = std::vector<std::optional<PairRow>>();
+    c.get_many(row, "t2", keys.begin(), keys.end(), std::back_inserter(rows));
+    REQUIRE(rows.size() == 3);
+    REQUIRE(rows[0]->m_c == 12);
+    REQUIRE(!rows[1]);
+    REQUIRE(rows[2]->m_c == 11);
+  }
+}
@@ -0,0 +1,133 @@
+#include <catch.hpp>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "Viper/Sqlite3/Sqlite3.hpp"
+
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  struct Listing {
+    std::string m_venue;
+    int m_id;
+    std::string m_currency;
+  };
+
+  std::istream& operator >>(std::istream& in, Listing& listing) {
+    return in >> listing.m_venue >> listing.m_id >> listing.m_currency;
+  }
+
+  auto get_listing_row() {
+    return Row<Listing>().
+      add_column("venue", &Listing::m_venue).
+      add_column("id", &Listing::m_id).
+      add_column("currency", &Listing::m_currency).
+      set_primary_key({"venue", "id"});
+  }
+
+  auto get_id_row() {
+    return Row<Listing>().
+      add_column("id", &Listing::m_id).
+      set_primary_key("id").
+      add_column("venue", &Listing::m_venue).
+      add_column("currency", &Listing::m_currency);
+  }
+}
+
+TEST_CASE("test_mirrored_table", "[MirroredTable]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_listing_row(), "listings"));
+  auto values = std::vector<Listing>{{"TSX", 1, "CAD"}, {"TSX", 2, "CAD"},
+    {"NYSE", 1, "USD"}};
+  c.execute(insert(get_listing_row(), "listings", values.begin(),
+    values.end()));
+  auto mirror = MirroredTable(get_listing_row(), "listings");
+  mirror.load(c);
+  REQUIRE(mirror.get_size() == 3);
+  REQUIRE(mirror.find(std::tuple(std::string("NYSE"), 1))->m_currency ==
+    "USD");
+  REQUIRE(mirror.find(std::tuple(std::string("NYSE"), 2)) == nullptr);
+  auto updates = std::vector<Listing>{{"NYSE", 1, "EUR"}, {"NYSE", 2, "USD"}};
+  mirror.upsert(c, updates.begin(), updates.end());
+  REQUIRE(mirror.get_size() == 4);
+  REQUIRE(mirror.find(std::pair(std::string("NYSE"), 1))->m_currency ==
+    "EUR");
+  REQUIRE(mirror.erase(c, std::tuple(std::string("TSX"), 1)));
+  REQUIRE(!mirror.erase(c, std::tuple(std::string("TSX"), 1)));
+  auto cad = std::vector<Listing>();
+  mirror.find_all("currency", std::string("CAD"), std::back_inserter(cad));
+  REQUIRE(cad.size() == 1);
+  REQUIRE(cad.front().m_id == 2);
+  auto reloaded = MirroredTable(get_listing_row(), "listings");
+  reloaded.load(c);
+  REQUIRE(reloaded.get_size() == mirror.get_size());
+  for(auto& value : reloaded.get_values()) {
+    auto match = mirror.find(std::tuple(value.m_venue, value.m_id));
+    REQUIRE(match != nullptr);
+    REQUIRE(match->m_currency == value.m_currency);
+  }
+}
+
+TEST_CASE("test_mirrored_table_churn", "[MirroredTable]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_id_row(), "instruments"));
+  auto mirror = MirroredTable(get_id_row(), "instruments");
+  mirror.add_index("currency");
+  mirror.load(c);
+  auto values = std::vector<Listing>();
+  for(auto i = 0; i != 1000; ++i) {
+    values.push_back(Listing{"TSX", i, "CAD"});
+  }
+  mirror.insert(c, values.begin(), values.end());
+  for(auto i = 0; i < 1000; i += 2) {
+    REQUIRE(mirror.erase(c, i));
+  }
+  REQUIRE(mirror.get_size() == 500);
+  auto updates = std::vector<Listing>{{"NYSE", 1, "USD"}, {"NYSE", 3, "USD"}};
+  mirror.upsert(c, updates.begin(), updates.end());
+  auto cad = std::vector<Listing>();
+  mirror.find_all("currency", std::string("CAD"), std::back_inserter(cad));
+  REQUIRE(cad.size() == 498);
+  for(auto& listing : cad) {
+    REQUIRE(listing.m_id % 2 == 1);
+    REQUIRE(listing.m_currency == "CAD");
+  }
+  auto usd = std::vector<Listing>();
+  mirror.find_all("currency", std::string("USD"), std::back_inserter(usd));
+  REQUIRE(usd.size() == 2);
+  for(auto i = 0; i != 1000; ++i) {
+    auto match = mirror.find(i);
+    REQUIRE((match != nullptr) == (i % 2 == 1));
+    if(match) {
+      REQUIRE(match->m_id == i);
+    }
+  }
+  auto row = Listing();
+  c.execute(select(Viper::count("*"), "instruments", &row.m_id));
+  REQUIRE(row.m_id == 500);
+}
+
+TEST_CASE("test_mirrored_table_input_iterator", "[MirroredTable]") {
+  auto c = Connection(":memory:");
+  c.open();
+  c.execute(create(get_id_row(), "instruments"));
+  auto mirror = MirroredTable(get_id_row(), "instruments");
+  mirror.load(c);
+  auto inserts = std::istringstream("TSX 1 CAD TSX 2 CAD TSX 3 CAD");
+  mirror.insert(c, std::istream_iterator<Listing>(inserts),
+    std::istream_iterator<Listing>());
+  auto upserts = std::istringstream("NYSE 3 USD NYSE 4 USD");
+  mirror.upsert(c, std::istream_iterator<Listing>(upserts),
+    std::istream_iterator<Listing>());
+  REQUIRE(mirror.get_size() == 4);
+  REQUIRE(mirror.find(2)->m_venue == "TSX");
+  REQUIRE(mirror.find(3)->m_currency == "USD");
+  auto row = Listing();
+  c.execute(select(Viper::count("*"), "instruments", &row.m_id));
+  REQUIRE(row.m_id == 4);
+}
@@ -0,0 +1,109 @@
+#include <filesystem>
+#include <mutex>
+#include <catch.hpp>
+#include "Viper/Sqlite3/Sqlite3.hpp"
+
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  struct Fill {
+    int m_id;
+    int m_account;
+  };
+
+  auto get_row() {
+    return Row<Fill>().
+      add_column("id", &Fill::m_id).
+      set_primary_key("id").
+      add_column("account", &Fill::m_account);
+  }
+
+  struct Database {
+    std::string m_path;
+    ConnectionPool<Connection> m_connections;
+
+    Database()
+      : m_path((std::filesystem::temp_directory_path() /
+          "viper_parallel_select.db").string()),
+        m_connections(4, [this] {
+          return Connection(m_path);
+        }) {
+      std::filesystem::remove(m_path);
+      auto c = Connection(m_path);
+      c.open();
+      c.execute(create(get_row(), "fills"));
+      auto fills = std::vector<Fill>();
+      for(auto i = 0; i != 1000; ++i) {
+        fills.push_back(Fill{i, i % 3});
+      }
+      c.execute(insert(get_row(), "fills", fills.begin(), fills.end()));
+    }
+
+    ~Database() {
+      std::filesystem::remove(m_path);
+    }
+  };
+
+  struct LockedSink {
+    std::mutex* m_mutex;
+    std::vector<Fill>* m_fills;
+
+    LockedSink& operator *() {
+      return *this;
+    }
+
+    LockedSink& operator ++() {
+      return *this;
+    }
+
+    LockedSink& operator =(Fill fill) {
+      auto lock = std::lock_guard(*m_mutex);
+      m_fills->push_back(fill);
+      return *this;
+    }
+  };
+}
+
+TEST_CASE("test_parallel_select_ordered", "[parallel_select]") {
+  auto database = Database();
+  auto threads = ThreadPool(3);
+  auto fills = std::vector<Fill>();
+  parallel_select<int>(database.m_connections, threads,
+    select(get_row(), "fills", sym("account") == 1,
+      std::back_inserter(fills)), "id", 7);
+  REQUIRE(fills.size() == 333);
+  for(auto i = std::size_t(0); i != fills.size(); ++i) {
+    REQUIRE(fills[i].m_id == static_cast<int>(3 * i + 1));
+  }
+  REQUIRE(database.m_connections.get_statistics().m_checkouts > 7);
+  auto top = std::vector<Fill>();
+  parallel_select(database.m_connections, threads,
+    select(get_row(), "fills", order_by("id", Order::DESC), limit(5),
+      std::back_inserter(top)), "id", std::vector<int>{250, 500, 750});
+  REQUIRE(top.size() == 5);
+  REQUIRE(top.front().m_id == 999);
+  REQUIRE(top.back().m_id == 995);
+  auto first = std::vector<Fill>();
+  parallel_select<int>(database.m_connections, threads,
+    select(get_row(), "fills", limit(3), std::back_inserter(first)), "id", 4);
+  REQUIRE(first.size() == 3);
+  REQUIRE(first.back().m_id == 2);
+}
+
+TEST_CASE("test_parallel_select_concurrent", "[parallel_select]") {
+  auto database = Database();
+  auto threads = ThreadPool(3);
+  auto mutex = std::mutex();
+  auto fills = std::vector<Fill>();
+  parallel_select<int>(database.m_connections, threads,
+    select(get_row(), "fills", LockedSink{&mutex, &fills}), "id", 8,
+    ScanMode::CONCURRENT);
+  REQUIRE(fills.size() == 1000);
+  std::sort(fills.begin(), fills.end(), [] (auto& left, auto& right) {
+    return left.m_id < right.m_id;
+  });
+  for(auto i = 0; i != 1000; ++i) {
+    REQUIRE(fills[i].m_id == i);
+  }
+}
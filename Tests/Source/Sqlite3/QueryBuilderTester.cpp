@@ -30,6 +30,23 @@ TEST_CASE("test_build_create_table_query", "[sqlite3_query_builder]") {
     "CREATE TABLE t1(x INTEGER NOT NULL,y REAL NOT NULL,PRIMARY KEY(x));");
 }
 
+TEST_CASE("test_build_prepared_insert_query", "[sqlite3_query_builder]") {
+  auto row = TableRow{1, 2};
+  auto s = insert(get_row(), "t1", &row);
+  std::string q;
+  build_prepared_query(s, 2, q);
+  REQUIRE(q == "INSERT INTO t1 (x,y) VALUES (?,?),(?,?);");
+}
+
+TEST_CASE("test_build_prepared_upsert", "[sqlite3_query_builder]") {
+  auto row = TableRow{1, 2};
+  auto s = upsert(get_row(), "t1", &row);
+  auto q = std::string("unchanged ");
+  build_prepared_query(s, 2, q);
+  REQUIRE(q == "unchanged INSERT INTO t1 (x,y) VALUES (?,?),(?,?) "
+    "ON CONFLICT(x) DO UPDATE SET y = excluded.y;");
+}
+
 TEST_CASE("test_build_select_query", "[sqlite3_query_builder]") {
   SECTION("Simple select query.") {
     std::vector<TableRow> rows;
@@ -0,0 +1,97 @@
+#include <catch.hpp>
+#include "Viper/Sqlite3/Sqlite3.hpp"
+
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  struct Quote {
+    int m_id;
+    std::string m_symbol;
+    double m_price;
+  };
+
+  auto get_row() {
+    return Row<Quote>().
+      add_column("id", &Quote::m_id).
+      set_primary_key("id").
+      add_column("symbol", &Quote::m_symbol).
+      add_column("price", &Quote::m_price);
+  }
+
+  auto make_table(std::size_t count) {
+    auto shards = std::vector<Connection>();
+    for(auto i = std::size_t(0); i != count; ++i) {
+      shards.emplace_back(":memory:");
+    }
+    return ShardedTable<Connection, Quote>(std::move(shards),
+      [] (const Quote& quote) {
+        return std::hash<std::string>()(quote.m_symbol);
+      });
+  }
+}
+
+TEST_CASE("test_sharded_routing", "[sharded_table]") {
+  auto table = make_table(4);
+  table.open();
+  table.execute(create(get_row(), "quotes"));
+  auto quotes = std::vector<Quote>();
+  for(auto i = 0; i != 400; ++i) {
+    quotes.push_back(Quote{i, "S" + std::to_string(i % 16), i * 0.25});
+  }
+  table.execute(insert(get_row(), "quotes", quotes.begin(), quotes.end()));
+  auto total = std::size_t(0);
+  for(auto i = std::size_t(0); i != table.get_shard_count(); ++i) {
+    auto stored = std::vector<Quote>();
+    table.get_shard(i).execute(select(get_row(), "quotes",
+      std::back_inserter(stored)));
+    for(auto& quote : stored) {
+      REQUIRE(std::hash<std::string>()(quote.m_symbol) % 4 == i);
+    }
+    total += stored.size();
+  }
+  REQUIRE(total == 400);
+  quotes.resize(16);
+  for(auto& quote : quotes) {
+    quote.m_price = -1;
+  }
+  table.execute(upsert(get_row(), "quotes", quotes.begin(), quotes.end()));
+  auto updated = std::vector<Quote>();
+  table.execute(select(get_row(), "quotes", sym("price") < 0,
+    std::back_inserter(updated)));
+  REQUIRE(updated.size() == 16);
+}
+
+TEST_CASE("test_sharded_ordered_merge", "[sharded_table]") {
+  auto table = make_table(3);
+  table.open();
+  table.execute(create(get_row(), "quotes"));
+  auto quotes = std::vector<Quote>();
+  for(auto i = 0; i != 300; ++i) {
+    quotes.push_back(
+      Quote{i, "S" + std::to_string(i % 7), (i * 37) % 101 * 1.0});
+  }
+  table.execute(insert(get_row(), "quotes", quotes.begin(), quotes.end()));
+  auto merged = std::vector<Quote>();
+  table.execute(select(get_row(), "quotes",
+    order_by({{"price", Order::DESC}, {"id", Order::ASC}}), limit(25),
+    std::back_inserter(merged)));
+  std::sort(quotes.begin(), quotes.end(), [] (auto& left, auto& right) {
+    if(left.m_price != right.m_price) {
+      return left.m_price > right.m_price;
+    }
+    return left.m_id < right.m_id;
+  });
+  REQUIRE(merged.size() == 25);
+  for(auto i = 0; i != 25; ++i) {
+    REQUIRE(merged[i].m_id == quotes[i].m_id);
+  }
+  auto unordered = std::vector<Quote>();
+  table.execute(select(get_row(), "quotes", limit(10),
+    std::back_inserter(unordered)));
+  REQUIRE(unordered.size() == 10);
+  auto ids = std::vector<int>();
+  REQUIRE_THROWS_AS(table.execute(select(Row<int>("id"), "quotes",
+    order_by("price", Order::ASC), std::back_inserter(ids))),
+    ExecuteException);
+}
@@ -0,0 +1,122 @@
+#include <filesystem>
+#include <thread>
+#include <catch.hpp>
+#include "Viper/WriteBehind.hpp"
+#include "Viper/Sqlite3/Sqlite3.hpp"
+
+using namespace Viper;
+using namespace Viper::Sqlite3;
+
+namespace {
+  struct Trade {
+    int m_id;
+    int m_quantity;
+  };
+
+  auto get_row() {
+    return Row<Trade>().
+      add_column("id", &Trade::m_id).
+      set_primary_key("id").
+      add_column("quantity", &Trade::m_quantity);
+  }
+
+  struct Database {
+    std::string m_path;
+
+    Database()
+      : m_path((std::filesystem::temp_directory_path() /
+          "viper_write_behind.db").string()) {
+      std::filesystem::remove(m_path);
+      auto c = Connection(m_path);
+      c.open();
+      c.execute(create(get_row(), "trades"));
+    }
+
+    ~Database() {
+      std::filesystem::remove(m_path);
+    }
+
+    Connection open() const {
+      auto c = Connection(m_path);
+      c.open();
+      return c;
+    }
+
+    std::vector<Trade> load() const {
+      auto c = open();
+      auto trades = std::vector<Trade>();
+      c.execute(select(get_row(), "trades", std::back_inserter(trades)));
+      return trades;
+    }
+  };
+}
+
+TEST_CASE("test_write_behind_coalescing", "[write_behind]") {
+  auto database = Database();
+  auto writer = WriteBehind(database.open(), get_row(), "trades",
+    WriteMode::UPSERT);
+  for(auto i = 0; i != 1000; ++i) {
+    writer.push(Trade{i % 10, i});
+  }
+  writer.flush();
+  auto statistics = writer.get_statistics();
+  REQUIRE(statistics.m_depth == 0);
+  REQUIRE(statistics.m_enqueued == 1000);
+  REQUIRE(statistics.m_written + statistics.m_coalesced == 1000);
+  REQUIRE(statistics.m_flushes != 0);
+  auto trades = database.load();
+  REQUIRE(trades.size() == 10);
+  for(auto& trade : trades) {
+    REQUIRE(trade.m_quantity == 990 + trade.m_id);
+  }
+}
+
+TEST_CASE("test_write_behind_producers", "[write_behind]") {
+  auto database = Database();
+  {
+    auto writer = WriteBehind(database.open(), get_row(), "trades",
+      WriteMode::INSERT, 64, 16);
+    auto producers = std::vector<std::thread>();
+    for(auto i = 0; i != 4; ++i) {
+      producers.emplace_back([&, i] {
+        for(auto j = 0; j != 1000; ++j) {
+          writer.push(Trade{1000 * i + j, j});
+        }
+      });
+    }
+    for(auto& producer : producers) {
+      producer.join();
+    }
+  }
+  auto trades = database.load();
+  REQUIRE(trades.size() == 4000);
+}
+
+TEST_CASE("test_write_behind_backpressure", "[write_behind]") {
+  auto database = Database();
+  auto writer = WriteBehind(database.open(), get_row(), "trades",
+    WriteMode::INSERT, 4, 1000, std::chrono::hours(1));
+  for(auto i = 0; i != 4; ++i) {
+    REQUIRE(writer.try_push(Trade{i, i}));
+  }
+  REQUIRE(!writer.try_push(Trade{4, 4}));
+  REQUIRE(writer.get_statistics().m_rejected == 1);
+  REQUIRE(writer.get_statistics().m_depth == 4);
+  writer.flush();
+  REQUIRE(writer.get_statistics().m_written == 4);
+  REQUIRE(database.load().size() == 4);
+}
+
+TEST_CASE("test_write_behind_flush_size", "[write_behind]") {
+  auto database = Database();
+  auto writer = WriteBehind(database.open(), get_row(), "trades",
+    WriteMode::INSERT, 64, 8, std::chrono::hours(1));
+  for(auto i = 0; i != 20; ++i) {
+    writer.push(Trade{i, i});
+  }
+  writer.flush();
+  auto statistics = writer.get_statistics();
+  REQUIRE(statistics.m_written == 20);
+  REQUIRE(statistics.m_flushes >= 3);
+  REQUIRE(database.load().size() == 20);
+}
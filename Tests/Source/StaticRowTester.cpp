@@ -0,0 +1,61 @@
+#include <array>
+#include <catch.hpp>
+#include "Viper/StaticRow.hpp"
+
+using namespace Viper;
+
+namespace {
+  struct Point {
+    int x;
+    double y;
+    std::string z;
+  };
+
+  using PointRow = StaticRow<Point, Field<"x", &Point::x>,
+    Field<"y", &Point::y>, Field<"z", &Point::z>>;
+}
+
+TEST_CASE("test_static_row_columns", "[static_row_tester]") {
+  auto row = PointRow().set_primary_key("x").add_index("z_index", "z");
+  REQUIRE(is_row_v<PointRow>);
+  REQUIRE(row.get_columns().size() == 3);
+  REQUIRE(row.get_columns()[0].m_name == "x");
+  REQUIRE(row.get_columns()[1].m_name == "y");
+  REQUIRE(row.get_columns()[2].m_name == "z");
+  REQUIRE(row.get_indexes().size() == 2);
+  REQUIRE(row.get_indexes()[0].m_is_primary);
+  REQUIRE(row.get_indexes()[1].m_name == "z_index");
+  REQUIRE(PointRow().get_indexes().empty());
+}
+
+TEST_CASE("test_static_row_extract", "[static_row_tester]") {
+  auto row = PointRow();
+  auto value = Point();
+  std::array<RawColumn, 3> row_values;
+  row_values[0].m_data = "123";
+  row_values[0].m_size = 3;
+  row_values[1].m_type = RawColumn::Type::REAL;
+  row_values[1].m_real = 4.5;
+  row_values[2].m_data = "abc";
+  row_values[2].m_size = 3;
+  row.extract(row_values.data(), value);
+  REQUIRE(value.x == 123);
+  REQUIRE(value.y == 4.5);
+  REQUIRE(value.z == "abc");
+}
+
+TEST_CASE("test_static_row_store_value", "[static_row_tester]") {
+  auto row = PointRow();
+  auto value = Point{5, 1.25, "text"};
+  auto column = RawColumn();
+  auto buffer = std::string();
+  row.store_value(value, 0, column, buffer);
+  REQUIRE(column.m_type == RawColumn::Type::INTEGER);
+  REQUIRE(column.m_integer == 5);
+  row.store_value(value, 2, column, buffer);
+  REQUIRE(column.m_type == RawColumn::Type::TEXT);
+  REQUIRE(std::string(column.m_data, column.m_size) == "text");
+  auto query = std::string();
+  row.append_value(value, 0, query);
+  REQUIRE(query == "5");
+}